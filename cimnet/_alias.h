@@ -0,0 +1,218 @@
+/*
+ * This file contains code from https://github.com/hxt-tg/cimnet
+ * and is covered under the copyright and warranty notices:
+ * "Copyright (C) 2022 CimNet Developers
+ *  Xintao Hu <hxt.taoge@gmail.com>"
+ */
+
+/*
+ *  This file contains alias tables, which draw one of n items with
+ *  probability proportional to given weights in O(1) (Walker's alias
+ *  method, built in O(n) by Vose's algorithm). Networks keep one table
+ *  per node for weighted random neighbors, built on the first draw and
+ *  dropped when the edges of the node change.
+ *  For further usage, check out http://doc.hxtcloud.cn.
+ */
+
+#ifndef CIMNET_ALIAS
+#define CIMNET_ALIAS
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "_exception.h"
+
+
+/* Alias table of n weighted items */
+class AliasTable {
+    public:
+    AliasTable () : _prob(), _alias() {}
+
+    /* Items 0 to n-1, item i weighing weight(i) >= 0. */
+    template <class _Weight>
+    AliasTable (int n, _Weight weight) : _prob(n), _alias(n) {
+        double total = 0;
+        for (int i = 0; i < n; i++) {
+            _prob[i] = weight(i);
+            if (!(_prob[i] >= 0)) throw NetworkException("Weights should be nonnegative.");
+            total += _prob[i];
+        }
+        if (!(total > 0)) throw NetworkException("No positive weights to draw from.");
+
+        /* Scale the mean weight to 1, then fill each light slot up to 1
+         * with its alias, a heavy item. */
+        std::vector<int> light, heavy;
+        for (int i = 0; i < n; i++) {
+            _prob[i] *= n / total;
+            _alias[i] = i;
+            (_prob[i] < 1 ? light : heavy).push_back(i);
+        }
+        while (!light.empty() && !heavy.empty()) {
+            int l = light.back(), h = heavy.back();
+            light.pop_back();
+            _alias[l] = h;
+            _prob[h] -= 1 - _prob[l];
+            if (_prob[h] < 1) {
+                heavy.pop_back();
+                light.push_back(h);
+            }
+        }
+        /* Left over by rounding errors, so nearly 1 */
+        for (int i : light) _prob[i] = 1;
+        for (int i : heavy) _prob[i] = 1;
+    }
+
+    inline int size() const {
+        return _prob.size();
+    }
+
+    template <class _Rng>
+    inline int sample(_Rng &rng) const {
+        int i = rng.randi(_prob.size());
+        return rng.randf() < _prob[i] ? i : _alias[i];
+    }
+
+    private:
+    std::vector<double> _prob;      /* chance of keeping slot i */
+    std::vector<int> _alias;        /* item taken otherwise */
+};
+
+
+/* Alias tables of the nodes of a network, in a hash table that readers
+ * fill without locks: an entry is built outside the table and pushed at
+ * the head of its chain by compare-and-swap, and is never changed once
+ * published, so a hit costs only atomic loads. Entries are dropped only
+ * by changes of the network, which must not run alongside reads anyway;
+ * the buckets grow at those times too. Copies start empty. */
+template <class _NId>
+class _AliasCache {
+    struct _Entry {
+        _Entry (const _NId &i, AliasTable &&t) : id(i), table(std::move(t)), next(nullptr) {}
+
+        _NId id;
+        AliasTable table;
+        _Entry *next;       /* fixed once published */
+    };
+
+    struct _Buckets {
+        explicit _Buckets (std::size_t n) : mask(n - 1), heads(new std::atomic<_Entry *>[n]) {
+            for (std::size_t b = 0; b < n; b++)
+                heads[b].store(nullptr, std::memory_order_relaxed);
+        }
+
+        std::size_t mask;
+        std::unique_ptr<std::atomic<_Entry *>[]> heads;
+    };
+
+    public:
+    _AliasCache () : _buckets(nullptr), _count(0) {}
+    _AliasCache (const _AliasCache &) : _buckets(nullptr), _count(0) {}
+
+    ~_AliasCache () {
+        clear();
+    }
+
+    _AliasCache &operator=(const _AliasCache &) {
+        clear();
+        return *this;
+    }
+
+    /* Table of id, built by build() if missing. n_nodes sizes the buckets
+     * on first use. Threads may call get at the same time; the reference
+     * stays valid until id is dropped. */
+    template <class _Build>
+    inline const AliasTable &get(const _NId &id, std::size_t n_nodes, _Build build) {
+        _Buckets *buckets = _buckets.load(std::memory_order_acquire);
+        if (!buckets) buckets = _make_buckets(n_nodes);
+        std::atomic<_Entry *> &head = buckets->heads[_hash(id) & buckets->mask];
+        _Entry *first = head.load(std::memory_order_acquire);
+        if (_Entry *hit = _find(first, nullptr, id)) return hit->table;
+
+        _Entry *entry = new _Entry(id, build());
+        for (;;) {
+            entry->next = first;
+            if (head.compare_exchange_weak(first, entry, std::memory_order_release, std::memory_order_acquire))
+                break;
+            /* Someone pushed first; take their table if it is ours. */
+            if (_Entry *hit = _find(first, entry->next, id)) {
+                delete entry;
+                return hit->table;
+            }
+        }
+        _count.fetch_add(1, std::memory_order_relaxed);
+        return entry->table;
+    }
+
+    /* Drop the table of id. Not to be called alongside get. */
+    inline void drop(const _NId &id) {
+        _Buckets *buckets = _buckets.load(std::memory_order_relaxed);
+        if (!buckets) return;
+        std::atomic<_Entry *> &head = buckets->heads[_hash(id) & buckets->mask];
+        _Entry *prev = nullptr, *e = head.load(std::memory_order_relaxed);
+        for (; e; prev = e, e = e->next) {
+            if (!(e->id == id)) continue;
+            if (prev) prev->next = e->next;
+            else head.store(e->next, std::memory_order_relaxed);
+            delete e;
+            _count.fetch_sub(1, std::memory_order_relaxed);
+            break;
+        }
+        if (_count.load(std::memory_order_relaxed) > 2 * (buckets->mask + 1)) _grow(buckets);
+    }
+
+    inline void clear() noexcept {
+        _Buckets *buckets = _buckets.exchange(nullptr, std::memory_order_relaxed);
+        if (!buckets) return;
+        for (std::size_t b = 0; b <= buckets->mask; b++)
+            for (_Entry *e = buckets->heads[b].load(std::memory_order_relaxed), *next; e; e = next) {
+                next = e->next;
+                delete e;
+            }
+        delete buckets;
+        _count.store(0, std::memory_order_relaxed);
+    }
+
+    private:
+    static inline std::size_t _hash(const _NId &id) {
+        std::size_t h = std::hash<_NId>()(id);
+        return h ^ (h >> 16);
+    }
+
+    /* Entry of id among the entries from e up to stop. */
+    static inline _Entry *_find(_Entry *e, _Entry *stop, const _NId &id) {
+        for (; e != stop; e = e->next)
+            if (e->id == id) return e;
+        return nullptr;
+    }
+
+    inline _Buckets *_make_buckets(std::size_t n_nodes) {
+        std::size_t n = 16;
+        while (n < n_nodes) n <<= 1;
+        _Buckets *made = new _Buckets(n), *expected = nullptr;
+        if (_buckets.compare_exchange_strong(expected, made, std::memory_order_acq_rel)) return made;
+        delete made;
+        return expected;
+    }
+
+    /* Rehash into four times the buckets, while no thread reads. */
+    inline void _grow(_Buckets *old) {
+        _Buckets *grown = new _Buckets(4 * (old->mask + 1));
+        for (std::size_t b = 0; b <= old->mask; b++)
+            for (_Entry *e = old->heads[b].load(std::memory_order_relaxed), *next; e; e = next) {
+                next = e->next;
+                std::atomic<_Entry *> &head = grown->heads[_hash(e->id) & grown->mask];
+                e->next = head.load(std::memory_order_relaxed);
+                head.store(e, std::memory_order_relaxed);
+            }
+        _buckets.store(grown, std::memory_order_release);
+        delete old;
+    }
+
+    std::atomic<_Buckets *> _buckets;
+    std::atomic<std::size_t> _count;
+};
+
+#endif /* ifndef CIMNET_ALIAS */
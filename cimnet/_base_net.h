@@ -18,27 +18,40 @@
 #include <vector>
 #include <iostream>
 #include <algorithm>
+#include <iterator>
+#include <tuple>
 
 #include "_types.h"
 #include "_exception.h"
 #include "random.h"
-
-
+#include "_storage.h"
+#include "_intersect.h"
+#include "_alias.h"
+#include "_edge_table.h"
+#include "_handle.h"
+#include "_view_net.h"
+#include "_frozen_net.h"
+#include "_compressed_net.h"
+#include "_stats.h"
+
+
+/* Hash of a pair. The two hashes are combined asymmetrically, so that
+ * (a, b) and (b, a) differ and (a, a) does not collapse to 0. */
 struct HashPair {
     template <class T1, class T2>
         std::size_t operator() (std::pair<T1, T2> const &p) const {
             std::size_t h1 = std::hash<T1>()(p.first);
             std::size_t h2 = std::hash<T2>()(p.second);
-            return h1 ^ h2;
+            return h1 ^ (h2 + 0x9e3779b97f4a7c15ULL + (h1 << 6) + (h1 >> 2));
         }
 };
 
 
 /* Network nodes view */
-template<class _NId, class _NData, class _EData>
+template<class _NId, class _NData, class _EData, class _Storage=HashStorage>
 class NodesViewIterator {
 public:
-    using _NType = typename std::unordered_map<_NId, _NData>;
+    using _NType = typename _Storage::template NodeMap<_NId, _NData>;
     using _NTypeIterator = typename _NType::const_iterator;
 
     explicit NodesViewIterator(const _NTypeIterator &iterator) : _iter{iterator} {}
@@ -60,12 +73,12 @@ private:
     _NTypeIterator _iter{};
 };
 
-template<class _NId, class _NData, class _EData>
+template<class _NId, class _NData, class _EData, class _Storage=HashStorage>
 class NodesView {
 public:
-    using _NType = typename std::unordered_map<_NId, _NData>;
+    using _NType = typename _Storage::template NodeMap<_NId, _NData>;
     using _NTypeIterator = typename _NType::const_iterator;
-    using _NodesViewIterator = NodesViewIterator<_NId, _NData, _EData>;
+    using _NodesViewIterator = NodesViewIterator<_NId, _NData, _EData, _Storage>;
 
     explicit NodesView(const _NTypeIterator &node_type_begin, const _NTypeIterator &node_type_end)
             : _begin(node_type_begin), _end(node_type_end) {}
@@ -85,10 +98,10 @@ private:
 
 
 /* Neighbor view */
-template<class _NId, class _NData, class _EData>
+template<class _NId, class _NData, class _EData, class _Storage=HashStorage>
 class NeighborViewIterator {
 public:
-    using _NeiType = typename std::unordered_map<_NId, _EData *>;
+    using _NeiType = typename _Storage::template NeighborMap<_NId, int>;
     using _NeiTypeIterator = typename _NeiType::const_iterator;
 
     explicit NeighborViewIterator(const _NeiTypeIterator &iterator) : _iter{iterator} {}
@@ -110,12 +123,12 @@ private:
     _NeiTypeIterator _iter{};
 };
 
-template<class _NId, class _NData, class _EData>
+template<class _NId, class _NData, class _EData, class _Storage=HashStorage>
 class NeighborView {
 public:
-    using _NeiType = typename std::unordered_map<_NId, _EData *>;
+    using _NeiType = typename _Storage::template NeighborMap<_NId, int>;
     using _NeiTypeIterator = typename _NeiType::const_iterator;
-    using _NeighborViewIterator = NeighborViewIterator<_NId, _NData, _EData>;
+    using _NeighborViewIterator = NeighborViewIterator<_NId, _NData, _EData, _Storage>;
 
     explicit NeighborView(const _NeiTypeIterator &nei_type_begin, const _NeiTypeIterator &nei_type_end)
             : _begin(nei_type_begin), _end(nei_type_end) {}
@@ -134,22 +147,186 @@ private:
 };
 
 
-template <class _NId=Id, class _NData=None, class _EData=None>
+/* Neighbor view of a directed network. Walks successors and then
+ * predecessors, skipping predecessors that are also successors, so each
+ * neighbor is yielded once. A predecessor is recognized as reciprocal by
+ * the reciprocal index when given (reverse[e] != -1 for edge e), and by
+ * looking it up among the successors otherwise. */
+template<class _NId, class _NData, class _EData, class _Storage=HashStorage>
+class DiNeighborViewIterator {
+public:
+    using _NeiType = typename _Storage::template NeighborMap<_NId, int>;
+
+    explicit DiNeighborViewIterator(const _NeiType *succ, const _NeiType *pred,
+            const std::vector<int> *reverse, int pos)
+            : _succ{succ}, _pred{pred}, _reverse{reverse}, _pos{pos} {
+        _skip();
+    }
+
+    bool operator!=(const DiNeighborViewIterator &other) const {
+        return _pos != other._pos;
+    }
+
+    const _NId &operator*() const {
+        int n_succ = _succ->size();
+        return _pos < n_succ ? _succ->nth(_pos).first : _pred->nth(_pos - n_succ).first;
+    }
+
+    const DiNeighborViewIterator &operator++() {
+        ++_pos;
+        _skip();
+        return *this;
+    }
+
+private:
+    void _skip() {
+        int n_succ = _succ->size(), n_all = n_succ + _pred->size();
+        while (_pos >= n_succ && _pos < n_all && _reciprocal(_pred->nth(_pos - n_succ)))
+            ++_pos;
+    }
+
+    bool _reciprocal(const std::pair<_NId, int> &p) const {
+        if (_reverse) return (*_reverse)[p.second] != -1;
+        return _succ->count(p.first) != 0;
+    }
+
+    const _NeiType *_succ{};
+    const _NeiType *_pred{};
+    const std::vector<int> *_reverse{};
+    int _pos{};
+};
+
+template<class _NId, class _NData, class _EData, class _Storage=HashStorage>
+class DiNeighborView {
+public:
+    using _NeiType = typename _Storage::template NeighborMap<_NId, int>;
+    using _DiNeighborViewIterator = DiNeighborViewIterator<_NId, _NData, _EData, _Storage>;
+
+    explicit DiNeighborView(const _NeiType &succ, const _NeiType &pred, const std::vector<int> *reverse)
+            : _succ(&succ), _pred(&pred), _reverse(reverse) {}
+
+    _DiNeighborViewIterator begin() const {
+        return _DiNeighborViewIterator(_succ, _pred, _reverse, 0);
+    }
+
+    _DiNeighborViewIterator end() const {
+        return _DiNeighborViewIterator(_succ, _pred, _reverse, _succ->size() + _pred->size());
+    }
+
+private:
+    const _NeiType *_succ{};
+    const _NeiType *_pred{};
+    const std::vector<int> *_reverse{};
+};
+
+
+/* Edges view. Walks the edge table of a network, yielding each edge
+ * once. Ends of undirected edges are given in ascending order. */
+template<class _NId, class _EData, bool _Directed>
+class EdgesViewIterator {
+public:
+    using _ETableType = EdgeTable<_NId, _EData>;
+
+    explicit EdgesViewIterator(const _ETableType *table, int index) : _table{table}, _index{index} {}
+
+    bool operator!=(const EdgesViewIterator &other) const {
+        return _index != other._index;
+    }
+
+    std::pair<_NId, _NId> operator*() const {
+        const auto &rec = _table->record(_index);
+        if (!_Directed && rec.second < rec.first)
+            return std::make_pair(rec.second, rec.first);
+        return std::make_pair(rec.first, rec.second);
+    }
+
+    const EdgesViewIterator &operator++() {
+        ++_index;
+        return *this;
+    }
+
+private:
+    const _ETableType *_table{};
+    int _index{};
+};
+
+template<class _NId, class _EData, bool _Directed>
+class EdgesView {
+public:
+    using _ETableType = EdgeTable<_NId, _EData>;
+    using _EdgesViewIterator = EdgesViewIterator<_NId, _EData, _Directed>;
+
+    explicit EdgesView(const _ETableType &table) : _table(&table) {}
+
+    _EdgesViewIterator begin() const {
+        return _EdgesViewIterator(_table, 0);
+    }
+
+    _EdgesViewIterator end() const {
+        return _EdgesViewIterator(_table, _table->size());
+    }
+
+private:
+    const _ETableType *_table{};
+};
+
+
+/* Helpers of bulk insertion */
+template <class _Iter>
+inline int _count_hint(_Iter begin, _Iter end, std::forward_iterator_tag) {
+    return std::distance(begin, end);
+}
+
+template <class _Iter>
+inline int _count_hint(_Iter, _Iter, std::input_iterator_tag) {
+    return 0;
+}
+
+template <class _Iter>
+inline int _count_hint(_Iter begin, _Iter end) {
+    return _count_hint(begin, end, typename std::iterator_traits<_Iter>::iterator_category());
+}
+
+template <class _EData, class _T1, class _T2>
+inline _EData _edge_data_of(const std::pair<_T1, _T2> &) {
+    return _EData();
+}
+
+template <class _EData, class _T1, class _T2, class _T3>
+inline const _T3 &_edge_data_of(const std::tuple<_T1, _T2, _T3> &e) {
+    return std::get<2>(e);
+}
+
+
+template <class _NId=Id, class _NData=None, class _EData=None, class _Storage=HashStorage>
 class Network;
-template <class _NId=Id, class _NData=None, class _EData=None>
+template <class _NId=Id, class _NData=None, class _EData=None, class _Storage=HashStorage>
 class DirectedNetwork;
+template <class _NId, class _NData, class _EData>
+class ParallelBuilder;
+template <class _NId, class _NData, class _EData>
+class Batch;
+template <class _Net, class _NId, class _NData, class _EData, class _Storage>
+class _SharedBase;
 
 /* Base class of undirected network */
-template <class _NId, class _NData, class _EData>
+template <class _NId, class _NData, class _EData, class _Storage>
 class Network {
-    typedef std::unordered_map<_NId, _NData> _NType;
+    typedef typename _Storage::template NodeMap<_NId, _NData> _NType;
     typedef std::pair<_NId, _NId> _EPairType;
-    typedef std::unordered_map<_NId, _EData *> _NeiType;
-    typedef std::unordered_map<_NId, _NeiType> _AdjType;
-    typedef Network<_NId, _NData, _EData> _NetType;
-    typedef DirectedNetwork<_NId, _NData, _EData> _DiNetType;
+    typedef typename _Storage::template NeighborMap<_NId, int> _NeiType;   /* neighbor -> edge index */
+    typedef typename _Storage::template NodeMap<_NId, _NeiType> _AdjType;
+    typedef Network<_NId, _NData, _EData, _Storage> _NetType;
+    typedef DirectedNetwork<_NId, _NData, _EData, _Storage> _DiNetType;
     typedef std::unordered_set<std::pair<_NId, _NId>, HashPair> _ESetType;
     typedef std::unordered_set<_NId> _NeiSetType;
+    typedef EdgeTable<_NId, _EData> _ETableType;
+
+    template <class, class, class> friend class ParallelBuilder;
+    template <class, class, class> friend class Batch;
+    template <class, class, class, class, class> friend class _SharedBase;
+    friend class _Checkpoint;
+    template <class, class, class> friend class FilteredView;
 
     friend std::ostream& operator<<(std::ostream& out, const Network& net) {
         out << "Network {#(node)=" << net.number_of_nodes()
@@ -159,41 +336,104 @@ class Network {
     }
 
     public:
-    Network (): _nodes(), _adjs() {}
-    Network (const _NetType &net) : _nodes(), _adjs() {
-        for (auto n: net._nodes)
-            add_node(n.first, n.second);
-        for (auto e: net.edges())
-            add_edge(e.first, e.second, net.get_edge_data(e.first, e.second));
-    }
-    explicit Network (const _DiNetType &net) : _nodes(), _adjs() {
+    Network (): _nodes(), _adjs(), _edges(), _degree_hint(0), _rehashes(0), _neighbor_stats(), _weights() {}
+    Network (const _NetType &net)
+        : _nodes(net._nodes), _adjs(net._adjs), _edges(net._edges), _degree_hint(net._degree_hint),
+          _rehashes(net._rehashes), _neighbor_stats(), _weights() {
+        _retally();
+    }
+    /* Take over the contents of net, leaving it empty. */
+    Network (_NetType &&net) noexcept
+        : _nodes(std::move(net._nodes)), _adjs(std::move(net._adjs)), _edges(std::move(net._edges)),
+          _degree_hint(net._degree_hint), _rehashes(net._rehashes), _neighbor_stats(net._neighbor_stats),
+          _weights() {
+        net.clear();
+    }
+    explicit Network (const _DiNetType &net)
+        : _nodes(), _adjs(), _edges(), _degree_hint(0), _rehashes(0), _neighbor_stats(), _weights() {
         for (auto n: net.nodes())
             add_node(n, net.get_node_data(n));
-        for (auto e: net.edges())
+        for (auto e: net.iterate_edges())
             add_edge(e.first, e.second, net.get_edge_data(e.first, e.second));
     }
 
     ~Network () {
-        for (auto &n : nodes())
-            remove_node(n);
+        clear();
+    }
+
+    /* Copies may size their containers differently, so the totals of
+     * the neighbor maps are taken again. */
+    Network &operator=(const _NetType &net) {
+        if (this == &net) return *this;
+        _nodes = net._nodes;
+        _adjs = net._adjs;
+        _edges = net._edges;
+        _degree_hint = net._degree_hint;
+        _rehashes = net._rehashes;
+        _weights.clear();
+        _retally();
+        return *this;
+    }
+
+    Network &operator=(_NetType &&net) noexcept {
+        if (this == &net) return *this;
+        _nodes = std::move(net._nodes);
+        _adjs = std::move(net._adjs);
+        _edges = std::move(net._edges);
+        _degree_hint = net._degree_hint;
+        _rehashes = net._rehashes;
+        _neighbor_stats = net._neighbor_stats;
+        _weights.clear();
+        net.clear();
+        return *this;
     }
 
     inline _NId add_node(const _NId &id,
             const _NData &node_data=_NData()) {
-        _nodes[id] = node_data;
-        _adjs[id] = _NeiType();
+        auto it = _nodes.find(id);
+        if (it != _nodes.end()) {
+            it->second = node_data;
+            return id;
+        }
+        _new_node(id, node_data);
         return id;
     }
 
+    /* Add nodes in [begin, end) with the same node data. */
+    template <class _Iter>
+    inline void add_nodes_from(_Iter begin, _Iter end,
+            const _NData &node_data=_NData()) {
+        _reserve_nodes(number_of_nodes() + _count_hint(begin, end));
+        for (; begin != end; ++begin)
+            add_node(*begin, node_data);
+    }
+
     inline void add_edge(const _NId &id1, const _NId &id2,
             const _EData &edge_data=_EData()) {
-        if (!has_node(id1)) add_node(id1);
-        if (!has_node(id2)) add_node(id2);
-        if (has_edge(id1, id2)) delete _adjs[id1][id2];
-        auto *data_ptr = new _EData();
-        *data_ptr = edge_data;
-        _adjs[id1][id2] = data_ptr;
-        _adjs[id2][id1] = data_ptr;
+        _touch(id1);
+        _NeiType &nei2 = _touch(id2);
+        auto r = _link(_adjs.at(id1), nei2, id1, id2, edge_data);
+        if (!r.second) _edges.data(r.first) = edge_data;
+    }
+
+    /* Add edges in [begin, end). Items are std::pair<_NId, _NId> or
+     * std::tuple<_NId, _NId, _EData>. Hash tables are sized up front
+     * for n_nodes nodes of about degree neighbors each. */
+    template <class _Iter>
+    inline void add_edges_from(_Iter begin, _Iter end,
+            int n_nodes=0, int degree=0) {
+        int hint = _degree_hint;
+        reserve(n_nodes, degree);
+        for (; begin != end; ++begin)
+            add_edge(std::get<0>(*begin), std::get<1>(*begin), _edge_data_of<_EData>(*begin));
+        _degree_hint = hint;
+    }
+
+    /* Reserve room for n_nodes nodes. Nodes created afterwards reserve
+     * room for degree neighbors. */
+    inline void reserve(int n_nodes, int degree=0) {
+        _reserve_nodes(n_nodes);
+        _degree_hint = degree;
     }
 
     inline void remove_edge(const _NId &id1, const _NId &id2) {
@@ -201,67 +441,78 @@ class Network {
         if (!has_node(id2)) throw NoNodeException<_NId>(id2);
         if (!has_edge(id1, id2)) throw NoEdgeException<_NId>(id1, id2);
         _NeiType &nei1 = _adjs.at(id1);
-        _NeiType &nei2 = _adjs.at(id2);
-        _EData *data_ptr = nei1.at(id2);
-        delete data_ptr;
-        nei1.erase(nei1.find(id2));
-        nei2.erase(nei2.find(id1));
+        _unlink(nei1, _adjs.at(id2), id1, id2, nei1.at(id2));
     }
 
     inline void remove_node(const _NId &id) {
         if (!has_node(id)) throw NoNodeException<_NId>(id);
         for (auto &n : neighbors(id))
             remove_edge(id, n);
-        _adjs.erase(_adjs.find(id));
+        auto it = _adjs.find(id);
+        _neighbor_stats -= _container_stats(it->second);
+        _adjs.erase(it);
         _nodes.erase(_nodes.find(id));
     }
 
+    /* Remove all nodes and edges and release their memory. Containers
+     * are dropped as a whole rather than node by node. */
+    inline void clear() noexcept {
+        _edges.clear();
+        _adjs = _AdjType();
+        _nodes = _NType();
+        _degree_hint = 0;
+        _rehashes = 0;
+        _neighbor_stats = ContainerStats();
+        _weights.clear();
+    }
+
     inline bool has_node(const _NId &id) const {
         return _nodes.find(id) != _nodes.end();
     }
 
     inline bool has_edge(const _NId &id1, const _NId &id2) const {
-        if (!has_node(id1) || !has_node(id2))
-            return false;
-        return _adjs.at(id1).find(id2) != _adjs.at(id1).end();
+        auto it = _adjs.find(id1);
+        return it != _adjs.end() && it->second.find(id2) != it->second.end();
     }
 
     inline bool is_neighbor(const _NId &id1, const _NId &id2) const {
         return has_edge(id1, id2);
     }
 
-    /* TODO: Optimize code structure of node and get_node_data. */
     inline _NData &node(const _NId &id) {
-        if (!has_node(id))
-            throw NoNodeException<_NId>(id);
-        return _nodes.at(id);
+        auto it = _nodes.find(id);
+        if (it == _nodes.end()) throw NoNodeException<_NId>(id);
+        return it->second;
     }
 
     inline _NData get_node_data(const _NId &id) const {
-        if (!has_node(id))
-            throw NoNodeException<_NId>(id);
-        return _nodes.at(id);
+        auto it = _nodes.find(id);
+        if (it == _nodes.end()) throw NoNodeException<_NId>(id);
+        return it->second;
     }
 
-    /* TODO: Optimize code structure of edge and get_edge_data. */
+    /* Writable edge data. Drops the alias tables of both ends, since
+     * the data may be a weight; read with get_edge_data to keep them. */
     inline _EData &edge(const _NId &id1, const _NId &id2) {
-        if (!has_node(id1)) throw NoNodeException<_NId>(id1);
-        if (!has_node(id2)) throw NoNodeException<_NId>(id2);
-        try {
-            return *(_adjs.at(id1).at(id2));
-        } catch (std::exception &e){
-            throw NoEdgeException<_NId>(id1, id2);
-        }
+        _weights_changed(id1, id2);
+        return _edges.data(_edge_index(id1, id2));
     }
 
     inline _EData get_edge_data(const _NId &id1, const _NId &id2) const {
-        if (!has_node(id1)) throw NoNodeException<_NId>(id1);
-        if (!has_node(id2)) throw NoNodeException<_NId>(id2);
-        try {
-            return *(_adjs.at(id1).at(id2));
-        } catch (std::exception &e){
-            throw NoEdgeException<_NId>(id1, id2);
-        }
+        return _edges.data(_edge_index(id1, id2));
+    }
+
+    /* Handle of node id, giving data and neighbors without further
+     * lookups. See _handle.h for how long it stays valid. */
+    inline NodeHandle<_NId, _NData, _EData, _Storage> node_handle(const _NId &id) {
+        auto it = _nodes.find(id);
+        if (it == _nodes.end()) throw NoNodeException<_NId>(id);
+        return NodeHandle<_NId, _NData, _EData, _Storage>(id, &it->second,
+                &_adjs.find(id)->second, &_edges, &_nodes, &_adjs);
+    }
+
+    inline EdgeHandle<_NId, _EData> edge_handle(const _NId &id1, const _NId &id2) {
+        return EdgeHandle<_NId, _EData>(&_edges, _edge_index(id1, id2));
     }
 
     inline int number_of_nodes() const {
@@ -269,7 +520,7 @@ class Network {
     }
 
     inline int number_of_edges() const {
-        return total_degree() / 2;
+        return _edges.size();
     }
 
     inline int total_degree() const {
@@ -296,19 +547,64 @@ class Network {
         return nei;
     }
 
-    inline NeighborView<_NId, _NData, _EData> iterate_neighbors(const _NId &id) const {
+    inline NeighborView<_NId, _NData, _EData, _Storage> iterate_neighbors(const _NId &id) const {
 //        if (!has_node(id)) throw NoNodeException<_NId>(id);
         const auto &_nei = _adjs.at(id);
-        return NeighborView<_NId, _NData, _EData>(_nei.begin(), _nei.end());
+        return NeighborView<_NId, _NData, _EData, _Storage>(_nei.begin(), _nei.end());
     }
 
-    inline _NId random_neighbor(const _NId &id) const {
+    template <class _Rng=MTEngine>
+    inline _NId random_neighbor(const _NId &id, _Rng &rng=default_engine()) const {
         if (!has_node(id)) throw NoNodeException<_NId>(id);
         int deg = degree(id);
         if (deg == 0) throw NoNeighborsException<_NId>(id);
-        auto it = _adjs.at(id).cbegin();
-        std::advance(it, randi(deg));
-        return it->first;
+        return _adjs.at(id).nth(rng.randi(deg)).first;
+    }
+
+    template <class _Rng=MTEngine>
+    inline _EPairType random_edge(_Rng &rng=default_engine()) const {
+        int n = number_of_edges();
+        if (n == 0) throw NetworkException("No edges in network.");
+        const auto &rec = _edges.record(rng.randi(n));
+        return std::make_pair(rec.first, rec.second);
+    }
+
+    /* Neighbor drawn with probability proportional to the weight of the
+     * edge to it, that is its edge data converted to double. The alias
+     * table of id is built on the first draw in O(degree), then draws
+     * take O(1) until the edges of id change. */
+    template <class _Rng=MTEngine>
+    inline _NId weighted_random_neighbor(const _NId &id, _Rng &rng=default_engine()) const {
+        auto it = _adjs.find(id);
+        if (it == _adjs.end()) throw NoNodeException<_NId>(id);
+        const _NeiType &nei = it->second;
+        if (nei.size() == 0) throw NoNeighborsException<_NId>(id);
+        const AliasTable &table = _weights.get(id, _nodes.size(), [&]() {
+            return AliasTable(nei.size(), [&](int i) { return (double)_edges.data(nei.nth(i).second); });
+        });
+        return nei.nth(table.sample(rng)).first;
+    }
+
+    /* Drop all alias tables. Needed only after changing weights through
+     * handles or references to edge data kept from earlier. */
+    inline void clear_weight_tables() noexcept {
+        _weights.clear();
+    }
+
+    /* Neighbors of both id1 and id2, without copying either list. With
+     * SortedStorage the two lists are merged, or galloped through when
+     * one is much longer; otherwise each neighbor of the node with
+     * fewer neighbors is looked up among the other's. */
+    inline std::vector<_NId> common_neighbors(const _NId &id1, const _NId &id2) const {
+        std::vector<_NId> nei;
+        _for_common_neighbors(id1, id2, [&](const _NId &n) { nei.push_back(n); });
+        return nei;
+    }
+
+    inline int count_common_neighbors(const _NId &id1, const _NId &id2) const {
+        int n = 0;
+        _for_common_neighbors(id1, id2, [&](const _NId &) { ++n; });
+        return n;
     }
 
     inline std::vector<_NId> nodes() const {
@@ -318,21 +614,68 @@ class Network {
         return nei;
     }
 
-    inline NodesView<_NId, _NData, _EData> iterate_nodes() const {
-        return NodesView<_NId, _NData, _EData>(_nodes.begin(), _nodes.end());
+    inline NodesView<_NId, _NData, _EData, _Storage> iterate_nodes() const {
+        return NodesView<_NId, _NData, _EData, _Storage>(_nodes.begin(), _nodes.end());
     }
 
     inline _ESetType edges() const {
         _ESetType e;
-        for (auto &i : _adjs)
-            for (auto &j : i.second) {
-                _NId _i = i.first, _j = j.first;
-                if (_i > _j) std::swap(_i, _j);
-                e.insert(std::make_pair(_i, _j));
-            }
+        e.reserve(number_of_edges());
+        for (auto p : iterate_edges())
+            e.insert(p);
         return e;
     }
 
+    inline EdgesView<_NId, _EData, false> iterate_edges() const {
+        return EdgesView<_NId, _EData, false>(_edges);
+    }
+
+    /* Sizes, hash table loads and estimated bytes of the containers.
+     * Neighbor maps are summed up as they change, so this takes O(1);
+     * only the largest load factor of a single neighbor map
+     * (max_load) needs to visit all of them, in O(number_of_nodes()). */
+    inline NetworkStats stats(bool max_load=true) const {
+        NetworkStats s;
+        s.nodes = _container_stats(_nodes);
+        if (max_load) {
+            _nested_stats(_adjs, s.adjacency, s.neighbors);
+        } else {
+            s.adjacency = _container_stats(_adjs);
+            s.neighbors = _neighbor_stats;
+            s.neighbors.bytes -= _adjs.size() * sizeof(_NeiType);
+            s.neighbors.max_load_factor = 0;
+        }
+        s.edges = _container_stats(_edges);
+        s.rehashes = _rehashes;
+        return s;
+    }
+
+    inline std::size_t memory_usage() const {
+        return stats(false).total_bytes();
+    }
+
+    inline FrozenNetwork<_NId, _NData, _EData> freeze() const {
+        return FrozenNetwork<_NId, _NData, _EData>(*this);
+    }
+
+    inline CompressedNetwork<_NId, _NData, _EData> compress() const {
+        return CompressedNetwork<_NId, _NData, _EData>(*this);
+    }
+
+    /* View of the nodes in nodes and the edges between them, without
+     * copying the network. */
+    inline FilteredView<_NetType, InNodeSet<_NId>> subgraph(std::unordered_set<_NId> nodes) const {
+        return FilteredView<_NetType, InNodeSet<_NId>>(*this, InNodeSet<_NId>(std::move(nodes)));
+    }
+
+    /* View of the nodes and edges accepted by the predicates, see
+     * _view_net.h. */
+    template <class _NodePred, class _EdgePred=AllEdges>
+    inline FilteredView<_NetType, _NodePred, _EdgePred> filtered_view(const _NodePred &node_pred,
+            const _EdgePred &edge_pred=_EdgePred()) const {
+        return FilteredView<_NetType, _NodePred, _EdgePred>(*this, node_pred, edge_pred);
+    }
+
     inline _NData &operator[](const _NId &id) {
         return node(id);
     }
@@ -342,21 +685,143 @@ class Network {
     }
 
     private:
+    /* Index of edge (id1, id2), found with a single probe of each map. */
+    inline int _edge_index(const _NId &id1, const _NId &id2) const {
+        auto it = _adjs.find(id1);
+        if (it == _adjs.end()) throw NoNodeException<_NId>(id1);
+        auto e = it->second.find(id2);
+        if (e == it->second.end()) {
+            if (!has_node(id2)) throw NoNodeException<_NId>(id2);
+            throw NoEdgeException<_NId>(id1, id2);
+        }
+        return e->second;
+    }
+
+    template <class _Func>
+    inline void _for_common_neighbors(const _NId &id1, const _NId &id2, _Func f) const {
+        auto it1 = _adjs.find(id1), it2 = _adjs.find(id2);
+        if (it1 == _adjs.end() || it2 == _adjs.end()) return;
+        _common_keys(it1->second, it2->second, f);
+    }
+
+    /* Neighbors of id, adding the node if absent. */
+    inline _NeiType &_touch(const _NId &id) {
+        auto it = _adjs.find(id);
+        if (it != _adjs.end()) return it->second;
+        return _new_node(id, _NData());
+    }
+
+    /* Add a node known to be absent. */
+    inline _NeiType &_new_node(const _NId &id, const _NData &node_data) {
+        std::size_t g = _growth_mark(_nodes) + _growth_mark(_adjs);
+        _nodes[id] = node_data;
+        _NeiType &nei = _new_neighbors(_adjs, id);
+        if (_growth_mark(_nodes) + _growth_mark(_adjs) != g) ++_rehashes;
+        _neighbor_stats += _container_stats(nei);
+        return nei;
+    }
+
+    inline _NeiType &_new_neighbors(_AdjType &adj, const _NId &id) {
+        _NeiType &nei = adj[id];
+        if (_degree_hint > 0) nei.reserve(_degree_hint);
+        return nei;
+    }
+
+    inline void _reserve_nodes(int n_nodes) {
+        if (n_nodes <= number_of_nodes()) return;
+        _nodes.reserve(n_nodes);
+        _adjs.reserve(n_nodes);
+    }
+
+    /* Link id1 and id2 through their neighbor maps nei1 and nei2. Return
+     * the edge index and whether the edge is new. The data of an
+     * existing edge is left unchanged. */
+    inline std::pair<int, bool> _link(_NeiType &nei1, _NeiType &nei2,
+            const _NId &id1, const _NId &id2, const _EData &edge_data) {
+        _weights_changed(id1, id2);
+        std::size_t g1 = _growth_mark(nei1), g2 = _growth_mark(nei2);
+        ContainerStats s = _both_stats(nei1, nei2);
+        auto r = nei1.emplace(id2, 0);
+        if (!r.second) return std::make_pair(r.first->second, false);
+        int e = _edges.insert(id1, id2, edge_data);
+        r.first->second = e;
+        nei2[id1] = e;
+        _rehashes += (_growth_mark(nei1) != g1) + (&nei1 != &nei2 && _growth_mark(nei2) != g2);
+        _neighbor_stats -= s;
+        _neighbor_stats += _both_stats(nei1, nei2);
+        return std::make_pair(e, true);
+    }
+
+    /* Remove edge e between id1 and id2, known to exist. */
+    inline void _unlink(_NeiType &nei1, _NeiType &nei2,
+            const _NId &id1, const _NId &id2, int e) {
+        _weights_changed(id1, id2);
+        _neighbor_stats -= _both_stats(nei1, nei2);
+        nei1.erase(id2);
+        nei2.erase(id1);
+        _neighbor_stats += _both_stats(nei1, nei2);
+        _release_edge(e);
+    }
+
+    /* Statistics of the neighbor maps of both ends, the same for a
+     * self-loop. */
+    static inline ContainerStats _both_stats(const _NeiType &nei1, const _NeiType &nei2) {
+        ContainerStats s = _container_stats(nei1);
+        if (&nei1 != &nei2) s += _container_stats(nei2);
+        return s;
+    }
+
+    /* Sum up the neighbor maps again, after they changed in bulk. */
+    inline void _retally() {
+        _neighbor_stats = ContainerStats();
+        for (auto &a : _adjs)
+            _neighbor_stats += _container_stats(a.second);
+    }
+
+    /* The edges or their data of id1 and id2 changed. */
+    inline void _weights_changed(const _NId &id1, const _NId &id2) {
+        _weights.drop(id1);
+        _weights.drop(id2);
+    }
+
+    /* Drop edge record e. If the last record moved into its slot,
+     * point both adjacency entries of the moved edge to e. */
+    inline void _release_edge(int e) {
+        if (!_edges.remove(e)) return;
+        const auto &rec = _edges.record(e);
+        _adjs.at(rec.first).at(rec.second) = e;
+        _adjs.at(rec.second).at(rec.first) = e;
+    }
+
     _NType _nodes;
     _AdjType _adjs;
+    _ETableType _edges;
+    int _degree_hint;
+    std::size_t _rehashes;
+    ContainerStats _neighbor_stats;        /* totals of all neighbor maps, kept as they change */
+    mutable _AliasCache<_NId> _weights;    /* alias table of each node, by need */
 };
 
 /* Base class of directed network */
-template <class _NId, class _NData, class _EData>
+template <class _NId, class _NData, class _EData, class _Storage>
 class DirectedNetwork {
-    typedef std::unordered_map<_NId, _NData> _NType;
+    typedef typename _Storage::template NodeMap<_NId, _NData> _NType;
     typedef std::pair<_NId, _NId> _EPairType;
-    typedef std::unordered_map<_NId, _EData *> _NeiType;
-    typedef std::unordered_map<_NId, _NeiType> _AdjType;
-    typedef Network<_NId, _NData, _EData> _NetType;
-    typedef DirectedNetwork<_NId, _NData, _EData> _DiNetType;
+    typedef typename _Storage::template NeighborMap<_NId, int> _NeiType;   /* neighbor -> edge index */
+    typedef typename _Storage::template NodeMap<_NId, _NeiType> _AdjType;
+    typedef Network<_NId, _NData, _EData, _Storage> _NetType;
+    typedef DirectedNetwork<_NId, _NData, _EData, _Storage> _DiNetType;
     typedef std::unordered_set<std::pair<_NId, _NId>, HashPair> _ESetType;
     typedef std::unordered_set<_NId> _NeiSetType;
+    typedef EdgeTable<_NId, _EData> _ETableType;
+
+    template <class, class, class> friend class ParallelBuilder;
+    template <class, class, class> friend class Batch;
+    template <class, class, class, class, class> friend class _SharedBase;
+    friend class _Checkpoint;
+    template <class, class, class> friend class FilteredView;
+    template <class, class, class, class> friend class ReverseView;
+    template <class, class, class, class> friend class UndirectedView;
 
     friend std::ostream& operator<<(std::ostream& out, const DirectedNetwork& net) {
         out << "Directed network {#(node)=" << net.number_of_nodes()
@@ -366,44 +831,112 @@ class DirectedNetwork {
     }
 
     public:
-    DirectedNetwork (): _nodes(), _pred(), _succ() {}
-    DirectedNetwork (const _DiNetType &net) : _nodes(), _pred(), _succ() {
-        for (auto n: net._nodes)
-            add_node(n.first, n.second);
-        for (auto e: net.edges())
-            add_edge(e.first, e.second, net.get_edge_data(e.first, e.second));
-    }
-    explicit DirectedNetwork (const _NetType &net): _nodes(), _pred(), _succ() {
+    DirectedNetwork (): _nodes(), _pred(), _succ(), _edges(), _degree_hint(0),
+        _reciprocal(false), _reverse(), _rehashes(0), _neighbor_stats(), _succ_weights(), _pred_weights() {}
+    DirectedNetwork (const _DiNetType &net)
+        : _nodes(net._nodes), _pred(net._pred), _succ(net._succ), _edges(net._edges),
+          _degree_hint(net._degree_hint), _reciprocal(net._reciprocal), _reverse(net._reverse),
+          _rehashes(net._rehashes), _neighbor_stats(), _succ_weights(), _pred_weights() {
+        _retally();
+    }
+    /* Take over the contents of net, leaving it empty. */
+    DirectedNetwork (_DiNetType &&net) noexcept
+        : _nodes(std::move(net._nodes)), _pred(std::move(net._pred)), _succ(std::move(net._succ)),
+          _edges(std::move(net._edges)), _degree_hint(net._degree_hint), _reciprocal(net._reciprocal),
+          _reverse(std::move(net._reverse)), _rehashes(net._rehashes),
+          _neighbor_stats(net._neighbor_stats), _succ_weights(), _pred_weights() {
+        net.clear();
+    }
+    explicit DirectedNetwork (const _NetType &net): _nodes(), _pred(), _succ(), _edges(), _degree_hint(0),
+        _reciprocal(false), _reverse(), _rehashes(0), _neighbor_stats(), _succ_weights(), _pred_weights() {
         for (auto n: net.nodes())
             add_node(n, net.get_node_data(n));
-        for (auto e: net.edges()) {
-            add_edge(e.first, e.second, net.get_edge_data(e.first, e.second));
-            add_edge(e.second, e.first, net.get_edge_data(e.first, e.second));
+        for (auto e: net.iterate_edges()) {
+            const _EData &data = net.get_edge_data(e.first, e.second);
+            add_edge(e.first, e.second, data);
+            add_edge(e.second, e.first, data);
         }
     }
 
     ~DirectedNetwork () {
-        for (auto &n : nodes())
-            remove_node(n);
+        clear();
+    }
+
+    /* See Network::operator=. */
+    DirectedNetwork &operator=(const _DiNetType &net) {
+        if (this == &net) return *this;
+        _nodes = net._nodes;
+        _pred = net._pred;
+        _succ = net._succ;
+        _edges = net._edges;
+        _degree_hint = net._degree_hint;
+        _reciprocal = net._reciprocal;
+        _reverse = net._reverse;
+        _rehashes = net._rehashes;
+        clear_weight_tables();
+        _retally();
+        return *this;
+    }
+
+    DirectedNetwork &operator=(_DiNetType &&net) noexcept {
+        if (this == &net) return *this;
+        _nodes = std::move(net._nodes);
+        _pred = std::move(net._pred);
+        _succ = std::move(net._succ);
+        _edges = std::move(net._edges);
+        _degree_hint = net._degree_hint;
+        _reciprocal = net._reciprocal;
+        _reverse = std::move(net._reverse);
+        _rehashes = net._rehashes;
+        _neighbor_stats = net._neighbor_stats;
+        clear_weight_tables();
+        net.clear();
+        return *this;
     }
 
     inline _NId add_node(const _NId &id,
             const _NData &node_data=_NData()) {
-        _nodes[id] = node_data;
-        _pred[id] = _NeiType();
-        _succ[id] = _NeiType();
+        auto it = _nodes.find(id);
+        if (it != _nodes.end()) {
+            it->second = node_data;
+            return id;
+        }
+        _new_node(id, node_data);
         return id;
     }
 
+    /* Add nodes in [begin, end) with the same node data. */
+    template <class _Iter>
+    inline void add_nodes_from(_Iter begin, _Iter end,
+            const _NData &node_data=_NData()) {
+        _reserve_nodes(number_of_nodes() + _count_hint(begin, end));
+        for (; begin != end; ++begin)
+            add_node(*begin, node_data);
+    }
+
     inline void add_edge(const _NId &id1, const _NId &id2,
             const _EData &edge_data=_EData()) {
-        if (!has_node(id1)) add_node(id1);
-        if (!has_node(id2)) add_node(id2);
-        if (has_edge(id1, id2)) delete _succ[id1][id2];
-        auto *data_ptr = new _EData();
-        *data_ptr = edge_data;
-        _succ[id1][id2] = data_ptr;
-        _pred[id2][id1] = data_ptr;
+        _touch(id1);
+        _touch(id2);
+        auto r = _link(_succ.at(id1), _pred.at(id2), id1, id2, edge_data);
+        if (!r.second) _edges.data(r.first) = edge_data;
+    }
+
+    /* Add edges in [begin, end), see Network::add_edges_from. The degree
+     * hint applies to both successors and predecessors. */
+    template <class _Iter>
+    inline void add_edges_from(_Iter begin, _Iter end,
+            int n_nodes=0, int degree=0) {
+        int hint = _degree_hint;
+        reserve(n_nodes, degree);
+        for (; begin != end; ++begin)
+            add_edge(std::get<0>(*begin), std::get<1>(*begin), _edge_data_of<_EData>(*begin));
+        _degree_hint = hint;
+    }
+
+    inline void reserve(int n_nodes, int degree=0) {
+        _reserve_nodes(n_nodes);
+        _degree_hint = degree;
     }
 
     inline void remove_edge(const _NId &id1, const _NId &id2) {
@@ -411,11 +944,7 @@ class DirectedNetwork {
         if (!has_node(id2)) throw NoNodeException<_NId>(id2);
         if (!has_edge(id1, id2)) throw NoEdgeException<_NId>(id1, id2, true);
         _NeiType &succ = _succ.at(id1);
-        _NeiType &pred = _pred.at(id2);
-        _EData *data_ptr = succ.at(id2);
-        delete data_ptr;
-        succ.erase(succ.find(id2));
-        pred.erase(pred.find(id1));
+        _unlink(succ, _pred.at(id2), id1, id2, succ.at(id2));
     }
 
     inline void remove_node(const _NId &id) {
@@ -424,23 +953,60 @@ class DirectedNetwork {
             remove_edge(id, n);
         for (auto &n : predecessors(id))
             remove_edge(n, id);
-        _succ.erase(_succ.find(id));
-        _pred.erase(_pred.find(id));
+        auto s = _succ.find(id), p = _pred.find(id);
+        _neighbor_stats -= _container_stats(s->second);
+        _neighbor_stats -= _container_stats(p->second);
+        _succ.erase(s);
+        _pred.erase(p);
         _nodes.erase(_nodes.find(id));
     }
 
+    /* Remove all nodes and edges and release their memory. Containers
+     * are dropped as a whole rather than node by node. */
+    inline void clear() noexcept {
+        _edges.clear();
+        _succ = _AdjType();
+        _pred = _AdjType();
+        _nodes = _NType();
+        _degree_hint = 0;
+        std::vector<int>().swap(_reverse);
+        _rehashes = 0;
+        _neighbor_stats = ContainerStats();
+        clear_weight_tables();
+    }
+
+    /* Keep, for every edge, the index of its reverse edge, so that
+     * reciprocal links are recognized without a lookup. Costs one int
+     * per edge while enabled. */
+    inline void enable_reciprocal_index(bool enable=true) {
+        _reciprocal = enable;
+        std::vector<int>().swap(_reverse);
+        if (!enable) return;
+        _reverse.assign(_edges.size(), -1);
+        for (int e = 0; e < _edges.size(); e++) {
+            const auto &rec = _edges.record(e);
+            const _NeiType &back = _succ.at(rec.second);
+            auto it = back.find(rec.first);
+            if (it != back.end()) _reverse[e] = it->second;
+        }
+    }
+
+    inline bool has_reciprocal_index() const {
+        return _reciprocal;
+    }
+
     inline bool has_node(const _NId &id) const {
         return _nodes.find(id) != _nodes.end();
     }
 
     inline bool has_successor(const _NId &id1, const _NId &id2) const {
-        if (!has_node(id1) || !has_node(id2)) return false;
-        return _succ.at(id1).find(id2) != _succ.at(id1).end();
+        auto it = _succ.find(id1);
+        return it != _succ.end() && it->second.find(id2) != it->second.end();
     }
 
     inline bool has_predecessor(const _NId &id1, const _NId &id2) const {
-        if (!has_node(id1) || !has_node(id2)) return false;
-        return _pred.at(id1).find(id2) != _pred.at(id1).end();
+        auto it = _pred.find(id1);
+        return it != _pred.end() && it->second.find(id2) != it->second.end();
     }
 
     inline bool has_edge(const _NId &id1, const _NId &id2) const {
@@ -453,38 +1019,41 @@ class DirectedNetwork {
                _pred.at(id1).find(id2) != _pred.at(id1).end();
     }
 
-    /* TODO: Optimize code structure of node and get_node_data. */
     inline _NData &node(const _NId &id) {
-        if (!has_node(id))
-            throw NoNodeException<_NId>(id);
-        return _nodes.at(id);
+        auto it = _nodes.find(id);
+        if (it == _nodes.end()) throw NoNodeException<_NId>(id);
+        return it->second;
     }
 
     inline _NData get_node_data(const _NId &id) const {
-        if (!has_node(id))
-            throw NoNodeException<_NId>(id);
-        return _nodes.at(id);
+        auto it = _nodes.find(id);
+        if (it == _nodes.end()) throw NoNodeException<_NId>(id);
+        return it->second;
     }
 
-    /* TODO: Optimize code structure of edge and get_edge_data. */
+    /* Writable edge data, dropping alias tables, see Network::edge. */
     inline _EData &edge(const _NId &id1, const _NId &id2) {
-        if (!has_node(id1)) throw NoNodeException<_NId>(id1);
-        if (!has_node(id2)) throw NoNodeException<_NId>(id2);
-        try {
-            return *(_succ.at(id1).at(id2));
-        } catch (std::exception &e){
-            throw NoEdgeException<_NId>(id1, id2);
-        }
+        _weights_changed(id1, id2);
+        return _edges.data(_edge_index(id1, id2));
     }
 
     inline _EData get_edge_data(const _NId &id1, const _NId &id2) const {
-        if (!has_node(id1)) throw NoNodeException<_NId>(id1);
-        if (!has_node(id2)) throw NoNodeException<_NId>(id2);
-        try {
-            return *(_succ.at(id1).at(id2));
-        } catch (std::exception &e){
-            throw NoEdgeException<_NId>(id1, id2);
-        }
+        return _edges.data(_edge_index(id1, id2));
+    }
+
+    /* Handle of node id, giving data, successors and predecessors
+     * without further lookups. See _handle.h for how long it stays
+     * valid. */
+    inline DiNodeHandle<_NId, _NData, _EData, _Storage> node_handle(const _NId &id) {
+        auto it = _nodes.find(id);
+        if (it == _nodes.end()) throw NoNodeException<_NId>(id);
+        auto s = _succ.find(id);
+        return DiNodeHandle<_NId, _NData, _EData, _Storage>(id, &it->second,
+                &s->second, &_pred.find(id)->second, &_edges, &_nodes, &_succ);
+    }
+
+    inline EdgeHandle<_NId, _EData> edge_handle(const _NId &id1, const _NId &id2) {
+        return EdgeHandle<_NId, _EData>(&_edges, _edge_index(id1, id2));
     }
 
     inline int number_of_nodes() const {
@@ -492,10 +1061,7 @@ class DirectedNetwork {
     }
 
     inline int number_of_edges() const {
-        int num = 0;
-        for (auto &adj : _succ)
-            num += adj.second.size();
-        return num;
+        return _edges.size();
     }
 
     inline int total_degree() const {
@@ -533,10 +1099,10 @@ class DirectedNetwork {
         return nei;
     }
 
-    inline NeighborView<_NId, _NData, _EData> iterate_successors(const _NId &id) const {
+    inline NeighborView<_NId, _NData, _EData, _Storage> iterate_successors(const _NId &id) const {
         if (!has_node(id)) throw NoNodeException<_NId>(id);
         const auto &_nei = _succ.at(id);
-        return NeighborView<_NId, _NData, _EData>(_nei.begin(), _nei.end());
+        return NeighborView<_NId, _NData, _EData, _Storage>(_nei.begin(), _nei.end());
     }
 
     inline std::vector<_NId> predecessors(const _NId &id) const {
@@ -547,40 +1113,88 @@ class DirectedNetwork {
         return nei;
     }
 
-    inline NeighborView<_NId, _NData, _EData> iterate_predecessors(const _NId &id) const {
+    inline NeighborView<_NId, _NData, _EData, _Storage> iterate_predecessors(const _NId &id) const {
         if (!has_node(id)) throw NoNodeException<_NId>(id);
         const auto &_nei = _pred.at(id);
-        return NeighborView<_NId, _NData, _EData>(_nei.begin(), _nei.end());
+        return NeighborView<_NId, _NData, _EData, _Storage>(_nei.begin(), _nei.end());
     }
 
-    inline _NId random_successor(const _NId &id) const {
+    template <class _Rng=MTEngine>
+    inline _NId random_successor(const _NId &id, _Rng &rng=default_engine()) const {
         if (!has_node(id)) throw NoNodeException<_NId>(id);
         int deg = out_degree(id);
         if (deg == 0) throw NoNeighborsException<_NId>(id);
-        auto it = _succ.at(id).cbegin();
-        std::advance(it, randi(deg));
-        return it->first;
+        return _succ.at(id).nth(rng.randi(deg)).first;
     }
 
-    inline _NId random_predecessor(const _NId &id) const {
+    template <class _Rng=MTEngine>
+    inline _NId random_predecessor(const _NId &id, _Rng &rng=default_engine()) const {
         if (!has_node(id)) throw NoNodeException<_NId>(id);
         int deg = in_degree(id);
         if (deg == 0) throw NoNeighborsException<_NId>(id);
-        auto it = _pred.at(id).cbegin();
-        std::advance(it, randi(deg));
-        return it->first;
+        return _pred.at(id).nth(rng.randi(deg)).first;
+    }
+
+    /* Successor drawn with probability proportional to the weight of the
+     * edge to it, see Network::weighted_random_neighbor. */
+    template <class _Rng=MTEngine>
+    inline _NId weighted_random_successor(const _NId &id, _Rng &rng=default_engine()) const {
+        return _weighted_draw(_succ, _succ_weights, id, rng);
+    }
+
+    /* Predecessor drawn with probability proportional to the weight of
+     * the edge from it. */
+    template <class _Rng=MTEngine>
+    inline _NId weighted_random_predecessor(const _NId &id, _Rng &rng=default_engine()) const {
+        return _weighted_draw(_pred, _pred_weights, id, rng);
+    }
+
+    /* Drop all alias tables, see Network::clear_weight_tables. */
+    inline void clear_weight_tables() noexcept {
+        _succ_weights.clear();
+        _pred_weights.clear();
+    }
+
+    template <class _Rng=MTEngine>
+    inline _EPairType random_edge(_Rng &rng=default_engine()) const {
+        int n = number_of_edges();
+        if (n == 0) throw NetworkException("No edges in network.");
+        const auto &rec = _edges.record(rng.randi(n));
+        return std::make_pair(rec.first, rec.second);
     }
 
     inline std::vector<_NId> neighbors(const _NId &id) const {
-        _NeiSetType nei;
-        if (has_node(id)) {
-            for (auto &n : _succ.at(id))
-                nei.insert(n.first);
-            for (auto &n : _pred.at(id))
-                nei.insert(n.first);
-        }
-        return std::vector<_NId>(nei.begin(), nei.end());
-    }  // TODO: DirectedNetwork::iterate_neighbors
+        std::vector<_NId> nei;
+        if (has_node(id))
+            for (auto &n : iterate_neighbors(id))
+                nei.push_back(n);
+        return nei;
+    }
+
+    inline DiNeighborView<_NId, _NData, _EData, _Storage> iterate_neighbors(const _NId &id) const {
+        if (!has_node(id)) throw NoNodeException<_NId>(id);
+        return DiNeighborView<_NId, _NData, _EData, _Storage>(
+                _succ.at(id), _pred.at(id), _reciprocal ? &_reverse : nullptr);
+    }
+
+    /* Whether both id1 -> id2 and id2 -> id1 exist. */
+    inline bool is_mutual(const _NId &id1, const _NId &id2) const {
+        if (!has_node(id1) || !has_node(id2)) return false;
+        const _NeiType &succ = _succ.at(id1);
+        auto it = succ.find(id2);
+        if (it == succ.end()) return false;
+        if (_reciprocal) return _reverse[it->second] != -1;
+        return has_edge(id2, id1);
+    }
+
+    inline std::vector<_NId> mutual_neighbors(const _NId &id) const {
+        std::vector<_NId> nei;
+        if (!has_node(id)) return nei;
+        for (auto &n : _succ.at(id))
+            if (_reciprocal ? _reverse[n.second] != -1 : has_edge(n.first, id))
+                nei.push_back(n.first);
+        return nei;
+    }
 
     inline std::vector<_NId> nodes() const {
         std::vector<_NId> nei;
@@ -589,18 +1203,81 @@ class DirectedNetwork {
         return nei;
     }
 
-    inline NodesView<_NId, _NData, _EData> iterate_nodes() const {
-        return NodesView<_NId, _NData, _EData>(_nodes.begin(), _nodes.end());
+    inline NodesView<_NId, _NData, _EData, _Storage> iterate_nodes() const {
+        return NodesView<_NId, _NData, _EData, _Storage>(_nodes.begin(), _nodes.end());
     }
 
     inline _ESetType edges() const {
         _ESetType e;
-        for (auto &i : _succ)
-            for (auto &j : i.second)
-                e.insert(std::make_pair(i.first, j.first));
+        e.reserve(number_of_edges());
+        for (auto p : iterate_edges())
+            e.insert(p);
         return e;
     }
 
+    inline EdgesView<_NId, _EData, true> iterate_edges() const {
+        return EdgesView<_NId, _EData, true>(_edges);
+    }
+
+    /* Sizes, hash table loads and estimated bytes of the containers,
+     * see Network::stats. */
+    inline NetworkStats stats(bool max_load=true) const {
+        NetworkStats s;
+        s.nodes = _container_stats(_nodes);
+        if (max_load) {
+            _nested_stats(_succ, s.adjacency, s.neighbors);
+            _nested_stats(_pred, s.adjacency, s.neighbors);
+        } else {
+            s.adjacency = _container_stats(_succ);
+            s.adjacency += _container_stats(_pred);
+            s.neighbors = _neighbor_stats;
+            s.neighbors.bytes -= (_succ.size() + _pred.size()) * sizeof(_NeiType);
+            s.neighbors.max_load_factor = 0;
+        }
+        s.edges = _container_stats(_edges);
+        s.other_bytes = _heap_bytes(_reverse.capacity() * sizeof(int));
+        s.rehashes = _rehashes;
+        return s;
+    }
+
+    inline std::size_t memory_usage() const {
+        return stats(false).total_bytes();
+    }
+
+    inline FrozenDirectedNetwork<_NId, _NData, _EData> freeze() const {
+        return FrozenDirectedNetwork<_NId, _NData, _EData>(*this);
+    }
+
+    inline CompressedDirectedNetwork<_NId, _NData, _EData> compress() const {
+        return CompressedDirectedNetwork<_NId, _NData, _EData>(*this);
+    }
+
+    /* View of the nodes in nodes and the edges between them, without
+     * copying the network. */
+    inline FilteredView<_DiNetType, InNodeSet<_NId>> subgraph(std::unordered_set<_NId> nodes) const {
+        return FilteredView<_DiNetType, InNodeSet<_NId>>(*this, InNodeSet<_NId>(std::move(nodes)));
+    }
+
+    /* View of the nodes and edges accepted by the predicates, see
+     * _view_net.h. */
+    template <class _NodePred, class _EdgePred=AllEdges>
+    inline FilteredView<_DiNetType, _NodePred, _EdgePred> filtered_view(const _NodePred &node_pred,
+            const _EdgePred &edge_pred=_EdgePred()) const {
+        return FilteredView<_DiNetType, _NodePred, _EdgePred>(*this, node_pred, edge_pred);
+    }
+
+    /* View with every edge reversed, without copying the network. */
+    inline ReverseView<_NId, _NData, _EData, _Storage> reverse_view() const {
+        return ReverseView<_NId, _NData, _EData, _Storage>(*this);
+    }
+
+    /* View linking nodes joined by an edge in either direction, without
+     * copying the network. Unlike Network(const _DiNetType &), edge
+     * data is not duplicated. */
+    inline UndirectedView<_NId, _NData, _EData, _Storage> as_undirected_view() const {
+        return UndirectedView<_NId, _NData, _EData, _Storage>(*this);
+    }
+
     inline _NData &operator[](const _NId &id) {
         return node(id);
     }
@@ -610,9 +1287,144 @@ class DirectedNetwork {
     }
 
     private:
+    /* Index of edge (id1, id2), found with a single probe of each map. */
+    inline int _edge_index(const _NId &id1, const _NId &id2) const {
+        auto it = _succ.find(id1);
+        if (it == _succ.end()) throw NoNodeException<_NId>(id1);
+        auto e = it->second.find(id2);
+        if (e == it->second.end()) {
+            if (!has_node(id2)) throw NoNodeException<_NId>(id2);
+            throw NoEdgeException<_NId>(id1, id2);
+        }
+        return e->second;
+    }
+
+    inline void _touch(const _NId &id) {
+        if (has_node(id)) return;
+        _new_node(id, _NData());
+    }
+
+    /* Add a node known to be absent. */
+    inline void _new_node(const _NId &id, const _NData &node_data) {
+        std::size_t g = _growth_mark(_nodes) + _growth_mark(_pred) + _growth_mark(_succ);
+        _nodes[id] = node_data;
+        _neighbor_stats += _container_stats(_new_neighbors(_pred, id));
+        _neighbor_stats += _container_stats(_new_neighbors(_succ, id));
+        if (_growth_mark(_nodes) + _growth_mark(_pred) + _growth_mark(_succ) != g) ++_rehashes;
+    }
+
+    inline _NeiType &_new_neighbors(_AdjType &adj, const _NId &id) {
+        _NeiType &nei = adj[id];
+        if (_degree_hint > 0) nei.reserve(_degree_hint);
+        return nei;
+    }
+
+    inline void _reserve_nodes(int n_nodes) {
+        if (n_nodes <= number_of_nodes()) return;
+        _nodes.reserve(n_nodes);
+        _pred.reserve(n_nodes);
+        _succ.reserve(n_nodes);
+    }
+
+    /* Link id1 -> id2 through the successors succ of id1 and the
+     * predecessors pred of id2, see Network::_link. */
+    inline std::pair<int, bool> _link(_NeiType &succ, _NeiType &pred,
+            const _NId &id1, const _NId &id2, const _EData &edge_data) {
+        _weights_changed(id1, id2);
+        std::size_t g1 = _growth_mark(succ), g2 = _growth_mark(pred);
+        ContainerStats s = _container_stats(succ);
+        s += _container_stats(pred);
+        auto r = succ.emplace(id2, 0);
+        if (!r.second) return std::make_pair(r.first->second, false);
+        int e = _edges.insert(id1, id2, edge_data);
+        r.first->second = e;
+        pred[id1] = e;
+        _rehashes += (_growth_mark(succ) != g1) + (_growth_mark(pred) != g2);
+        _neighbor_stats -= s;
+        _neighbor_stats += _container_stats(succ);
+        _neighbor_stats += _container_stats(pred);
+        if (_reciprocal) {
+            const _NeiType &back = _succ.at(id2);
+            auto it = back.find(id1);
+            int rev = it == back.end() ? -1 : it->second;
+            _reverse.push_back(rev);
+            if (rev != -1) _reverse[rev] = e;
+        }
+        return std::make_pair(e, true);
+    }
+
+    /* Remove edge e from id1 to id2, known to exist. */
+    inline void _unlink(_NeiType &succ, _NeiType &pred,
+            const _NId &id1, const _NId &id2, int e) {
+        _weights_changed(id1, id2);
+        _neighbor_stats -= _container_stats(succ);
+        _neighbor_stats -= _container_stats(pred);
+        succ.erase(id2);
+        pred.erase(id1);
+        _neighbor_stats += _container_stats(succ);
+        _neighbor_stats += _container_stats(pred);
+        _release_edge(e);
+    }
+
+    /* Sum up the neighbor maps again, after they changed in bulk. */
+    inline void _retally() {
+        _neighbor_stats = ContainerStats();
+        for (auto &a : _succ)
+            _neighbor_stats += _container_stats(a.second);
+        for (auto &a : _pred)
+            _neighbor_stats += _container_stats(a.second);
+    }
+
+    /* The edge id1 -> id2 or its data changed. */
+    inline void _weights_changed(const _NId &id1, const _NId &id2) {
+        _succ_weights.drop(id1);
+        _pred_weights.drop(id2);
+    }
+
+    template <class _Rng>
+    inline _NId _weighted_draw(const _AdjType &adjs, _AliasCache<_NId> &weights,
+            const _NId &id, _Rng &rng) const {
+        auto it = adjs.find(id);
+        if (it == adjs.end()) throw NoNodeException<_NId>(id);
+        const _NeiType &nei = it->second;
+        if (nei.size() == 0) throw NoNeighborsException<_NId>(id);
+        const AliasTable &table = weights.get(id, _nodes.size(), [&]() {
+            return AliasTable(nei.size(), [&](int i) { return (double)_edges.data(nei.nth(i).second); });
+        });
+        return nei.nth(table.sample(rng)).first;
+    }
+
+    inline void _release_edge(int e) {
+        if (_reciprocal) _release_reverse(e);
+        if (!_edges.remove(e)) return;
+        const auto &rec = _edges.record(e);
+        _succ.at(rec.first).at(rec.second) = e;
+        _pred.at(rec.second).at(rec.first) = e;
+    }
+
+    /* Mirror the swap-removal of edge e in the reciprocal index. */
+    inline void _release_reverse(int e) {
+        int last = _edges.size() - 1;
+        if (_reverse[e] != -1) _reverse[_reverse[e]] = -1;
+        _reverse[e] = -1;
+        int moved = _reverse[last];
+        if (moved == last) moved = e;   /* self-loop */
+        _reverse[e] = moved;
+        if (moved != -1) _reverse[moved] = e;
+        _reverse.pop_back();
+    }
+
     _NType _nodes;
     _AdjType _pred;
     _AdjType _succ;   /* _adjs */
+    _ETableType _edges;
+    int _degree_hint;
+    bool _reciprocal;
+    std::vector<int> _reverse;   /* edge index -> index of reverse edge, or -1 */
+    std::size_t _rehashes;
+    ContainerStats _neighbor_stats;   /* see Network */
+    mutable _AliasCache<_NId> _succ_weights;   /* alias tables by need, see Network */
+    mutable _AliasCache<_NId> _pred_weights;
 };
 
 #endif /* ifndef CIMNET_BASE_NET */
@@ -0,0 +1,684 @@
+/*
+ * This file contains code from https://github.com/hxt-tg/cimnet
+ * and is covered under the copyright and warranty notices:
+ * "Copyright (C) 2022 CimNet Developers
+ *  Xintao Hu <hxt.taoge@gmail.com>"
+ */
+
+/*
+ *  This file contains compressed read-only snapshots of networks.
+ *  Nodes are sorted by id and remapped to indices 0 to n-1, so ids are
+ *  found by binary search without a hash index. Neighbors of each node
+ *  are sorted by index and stored as gaps between consecutive indices,
+ *  each gap written as a varint (7 bits per byte, the high bit marking
+ *  that more bytes follow). Neighbors are decoded on the fly while
+ *  iterating, so walking a row costs about the same as reading a CSR
+ *  row, while nodes with nearby indices take one byte per neighbor.
+ *  Looking up or picking a neighbor decodes the row, taking O(degree).
+ *  For further usage, check out http://doc.hxtcloud.cn.
+ */
+
+#ifndef CIMNET_COMPRESSED_NET
+#define CIMNET_COMPRESSED_NET
+
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <tuple>
+
+#include "_types.h"
+#include "_exception.h"
+#include "_stats.h"
+#include "random.h"
+
+
+/* Varint coding of unsigned gaps */
+inline void _write_varint(std::vector<unsigned char> &bytes, unsigned v) {
+    while (v >= 0x80) {
+        bytes.push_back((unsigned char)(v | 0x80));
+        v >>= 7;
+    }
+    bytes.push_back((unsigned char)v);
+}
+
+inline unsigned _read_varint(const unsigned char *&p) {
+    unsigned v = *p++;
+    if (v < 0x80) return v;   /* most gaps take one byte */
+    v &= 0x7f;
+    int shift = 7;
+    unsigned b;
+    do {
+        b = *p++;
+        v |= (b & 0x7f) << shift;
+        shift += 7;
+    } while (b & 0x80);
+    return v;
+}
+
+
+/* Compressed neighbor view */
+template<class _NId>
+class CompressedNeighborViewIterator {
+public:
+    CompressedNeighborViewIterator(const _NId *ids, const unsigned char *bytes, int left)
+            : _ids{ids}, _bytes{bytes}, _left{left}, _index{-1} {
+        if (_left > 0) _index += 1 + _read_varint(_bytes);
+    }
+
+    bool operator!=(const CompressedNeighborViewIterator &other) const {
+        return _left != other._left;
+    }
+
+    const _NId &operator*() const {
+        return _ids[_index];
+    }
+
+    const CompressedNeighborViewIterator &operator++() {
+        if (--_left > 0) _index += 1 + _read_varint(_bytes);
+        return *this;
+    }
+
+private:
+    const _NId *_ids{};
+    const unsigned char *_bytes{};
+    int _left{};
+    int _index{};
+};
+
+template<class _NId>
+class CompressedNeighborView {
+public:
+    using _CompressedNeighborViewIterator = CompressedNeighborViewIterator<_NId>;
+
+    CompressedNeighborView(const _NId *ids, const unsigned char *bytes, int degree)
+            : _ids(ids), _bytes(bytes), _degree(degree) {}
+
+    _CompressedNeighborViewIterator begin() const {
+        return _CompressedNeighborViewIterator(_ids, _bytes, _degree);
+    }
+
+    _CompressedNeighborViewIterator end() const {
+        return _CompressedNeighborViewIterator(_ids, _bytes, 0);
+    }
+
+private:
+    const _NId *_ids{};
+    const unsigned char *_bytes{};
+    int _degree{};
+};
+
+
+/* Gap-encoded rows. Row i holds slots slots[i] to slots[i+1]-1,
+ * encoded in bytes[offsets[i]] to bytes[offsets[i+1]-1]. */
+class _VarintAdjacency {
+    public:
+    _VarintAdjacency () : slots(1, 0), offsets(1, 0), bytes() {}
+
+    inline int degree(int i) const {
+        return (int)(slots[i + 1] - slots[i]);
+    }
+
+    inline const unsigned char *row(int i) const {
+        return bytes.data() + offsets[i];
+    }
+
+    /* Append the next row, given targets sorted ascending. */
+    inline void append(const int *begin, const int *end) {
+        int prev = -1;
+        for (const int *p = begin; p != end; ++p) {
+            _write_varint(bytes, (unsigned)(*p - prev - 1));
+            prev = *p;
+        }
+        slots.push_back(slots.back() + (end - begin));
+        offsets.push_back(bytes.size());
+    }
+
+    /* Slot of j in row i, or -1 if absent. */
+    inline long slot(int i, int j) const {
+        const unsigned char *p = row(i);
+        int t = -1;
+        for (std::size_t k = slots[i]; k < slots[i + 1]; k++) {
+            t += 1 + _read_varint(p);
+            if (t >= j) return t == j ? (long)k : -1;
+        }
+        return -1;
+    }
+
+    /* The k-th target of row i. */
+    inline int nth(int i, int k) const {
+        const unsigned char *p = row(i);
+        int t = -1;
+        for (int n = 0; n <= k; n++)
+            t += 1 + _read_varint(p);
+        return t;
+    }
+
+    inline void shrink_to_fit() {
+        slots.shrink_to_fit();
+        offsets.shrink_to_fit();
+        bytes.shrink_to_fit();
+    }
+
+    inline std::size_t memory_usage() const {
+        return _heap_bytes(slots.capacity() * sizeof(std::size_t))
+             + _heap_bytes(offsets.capacity() * sizeof(std::size_t))
+             + _heap_bytes(bytes.capacity());
+    }
+
+    std::vector<std::size_t> slots;
+    std::vector<std::size_t> offsets;
+    std::vector<unsigned char> bytes;
+};
+
+
+/* Node or edge data in index order. Data of type None take no memory. */
+template <class _Data>
+class _DataColumn {
+    public:
+    inline void push_back(const _Data &data) {
+        _data.push_back(data);
+    }
+
+    inline _Data &operator[](std::size_t k) {
+        return _data[k];
+    }
+
+    inline const _Data &operator[](std::size_t k) const {
+        return _data[k];
+    }
+
+    inline void reserve(std::size_t n) {
+        _data.reserve(n);
+    }
+
+    inline std::size_t memory_usage() const {
+        return _heap_bytes(_data.capacity() * sizeof(_Data));
+    }
+
+    private:
+    std::vector<_Data> _data;
+};
+
+template <>
+class _DataColumn<None> {
+    public:
+    inline void push_back(const None &) {}
+
+    inline None &operator[](std::size_t) {
+        return _none;
+    }
+
+    inline const None &operator[](std::size_t) const {
+        return _none;
+    }
+
+    inline void reserve(std::size_t) {}
+
+    inline std::size_t memory_usage() const {
+        return 0;
+    }
+
+    private:
+    None _none;
+};
+
+
+/* Sorted ids of a network, and helpers shared by compressed networks */
+template <class _NId>
+class _SortedIds {
+    public:
+    template <class _Net>
+    inline void assign_nodes(const _Net &net) {
+        ids.reserve(net.number_of_nodes());
+        for (auto &id : net.iterate_nodes())
+            ids.push_back(id);
+        std::sort(ids.begin(), ids.end());
+    }
+
+    /* Collect ends of edges in [begin, end) as ids. */
+    template <class _Iter>
+    inline void assign_edges(_Iter begin, _Iter end) {
+        for (; begin != end; ++begin) {
+            ids.push_back(std::get<0>(*begin));
+            ids.push_back(std::get<1>(*begin));
+        }
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+        ids.shrink_to_fit();
+    }
+
+    inline int find(const _NId &id) const {
+        auto it = std::lower_bound(ids.begin(), ids.end(), id);
+        if (it == ids.end() || id < *it) return -1;
+        return it - ids.begin();
+    }
+
+    inline int checked(const _NId &id) const {
+        int i = find(id);
+        if (i < 0) throw NoNodeException<_NId>(id);
+        return i;
+    }
+
+    /* Encode the sorted neighbors of every node into adj. neighbors(i, row)
+     * appends the neighbor indices of node i to row. */
+    template <class _Rows>
+    inline void encode(_VarintAdjacency &adj, _Rows neighbors) const {
+        std::vector<int> row;
+        for (int i = 0; i < (int)ids.size(); i++) {
+            row.clear();
+            neighbors(i, row);
+            std::sort(row.begin(), row.end());
+            row.erase(std::unique(row.begin(), row.end()), row.end());
+            adj.append(row.data(), row.data() + row.size());
+        }
+        adj.shrink_to_fit();
+    }
+
+    /* Encode edges in [begin, end) into adj, through a temporary CSR
+     * of one int per arc. Edge (u, v) puts v in the row of u if
+     * forward, and u in the row of v if backward. */
+    template <class _Iter>
+    inline void encode_edges(_VarintAdjacency &adj, _Iter begin, _Iter end,
+            bool forward, bool backward) const {
+        int n = ids.size();
+        std::vector<std::size_t> start(n + 1, 0);
+        for (_Iter it = begin; it != end; ++it) {
+            if (forward) ++start[find(std::get<0>(*it)) + 1];
+            if (backward) ++start[find(std::get<1>(*it)) + 1];
+        }
+        for (int i = 0; i < n; i++)
+            start[i + 1] += start[i];
+        std::vector<int> targets(start[n]);
+        std::vector<std::size_t> fill(start.begin(), start.end() - 1);
+        for (_Iter it = begin; it != end; ++it) {
+            int u = find(std::get<0>(*it)), v = find(std::get<1>(*it));
+            if (forward) targets[fill[u]++] = v;
+            if (backward) targets[fill[v]++] = u;
+        }
+        encode(adj, [&](int i, std::vector<int> &row) {
+            row.insert(row.end(), targets.begin() + start[i], targets.begin() + start[i + 1]);
+        });
+    }
+
+    inline std::size_t memory_usage() const {
+        return _heap_bytes(ids.capacity() * sizeof(_NId));
+    }
+
+    std::vector<_NId> ids;
+};
+
+
+/* Read-only compressed snapshot of an undirected network */
+template <class _NId=Id, class _NData=None, class _EData=None>
+class CompressedNetwork {
+    friend std::ostream& operator<<(std::ostream& out, const CompressedNetwork& net) {
+        out << "Compressed network {#(node)=" << net.number_of_nodes()
+            << ", #(edge)=" << net.number_of_edges()
+            << ", #(degree)=" << net.total_degree() << "}";
+        return out;
+    }
+
+    public:
+    CompressedNetwork () : _ids(), _ndata(), _adj(), _edata(), _n_edges(0) {}
+
+    /* Build from any undirected network exposing iterate_nodes,
+     * iterate_neighbors, get_node_data and get_edge_data. Node ids
+     * should be ordered by operator<. */
+    template <class _Net>
+    explicit CompressedNetwork (const _Net &net)
+            : _ids(), _ndata(), _adj(), _edata(), _n_edges(net.number_of_edges()) {
+        _ids.assign_nodes(net);
+        int n = _ids.ids.size();
+        _ndata.reserve(n);
+        for (int i = 0; i < n; i++)
+            _ndata.push_back(net.get_node_data(_ids.ids[i]));
+        _ids.encode(_adj, [&](int i, std::vector<int> &row) {
+            for (auto &nei : net.iterate_neighbors(_ids.ids[i]))
+                row.push_back(_ids.find(nei));
+        });
+        _edata.reserve(_adj.slots[n]);
+        for (int i = 0; i < n; i++)
+            for (auto &nei : iterate_neighbors(_ids.ids[i]))
+                _edata.push_back(net.get_edge_data(_ids.ids[i], nei));
+    }
+
+    /* Build from edges in [begin, end), given as std::pair<_NId, _NId>,
+     * without building a Network first. Repeated edges are merged, and
+     * node and edge data are default. */
+    template <class _Iter>
+    CompressedNetwork (_Iter begin, _Iter end)
+            : _ids(), _ndata(), _adj(), _edata(), _n_edges(0) {
+        _ids.assign_edges(begin, end);
+        int n = _ids.ids.size();
+        for (int i = 0; i < n; i++)
+            _ndata.push_back(_NData());
+        _ids.encode_edges(_adj, begin, end, true, true);
+        _edata.reserve(_adj.slots[n]);
+        for (std::size_t k = 0; k < _adj.slots[n]; k++)
+            _edata.push_back(_EData());
+        long degree = _adj.slots[n];
+        for (int i = 0; i < n; i++)
+            if (_adj.slot(i, i) >= 0) ++degree;   /* a self-loop takes one slot */
+        _n_edges = degree / 2;
+    }
+
+    inline bool has_node(const _NId &id) const {
+        return _ids.find(id) >= 0;
+    }
+
+    inline bool has_edge(const _NId &id1, const _NId &id2) const {
+        int i = _ids.find(id1), j = _ids.find(id2);
+        if (i < 0 || j < 0) return false;
+        return _adj.slot(i, j) >= 0;
+    }
+
+    inline bool is_neighbor(const _NId &id1, const _NId &id2) const {
+        return has_edge(id1, id2);
+    }
+
+    inline _NData &node(const _NId &id) {
+        return _ndata[_ids.checked(id)];
+    }
+
+    inline _NData get_node_data(const _NId &id) const {
+        return _ndata[_ids.checked(id)];
+    }
+
+    inline _EData get_edge_data(const _NId &id1, const _NId &id2) const {
+        long k = _adj.slot(_ids.checked(id1), _ids.checked(id2));
+        if (k < 0) throw NoEdgeException<_NId>(id1, id2);
+        return _edata[k];
+    }
+
+    inline int number_of_nodes() const {
+        return _ids.ids.size();
+    }
+
+    inline int number_of_edges() const {
+        return _n_edges;
+    }
+
+    inline int total_degree() const {
+        return _adj.slots.back();
+    }
+
+    inline int degree(const _NId &id) const {
+        int i = _ids.find(id);
+        if (i < 0) return 0;
+        return _adj.degree(i);
+    }
+
+    inline std::vector<_NId> neighbors(const _NId &id) const {
+        std::vector<_NId> nei;
+        if (has_node(id))
+            for (auto &n : iterate_neighbors(id))
+                nei.push_back(n);
+        return nei;
+    }
+
+    inline CompressedNeighborView<_NId> iterate_neighbors(const _NId &id) const {
+        int i = _ids.checked(id);
+        return CompressedNeighborView<_NId>(_ids.ids.data(), _adj.row(i), _adj.degree(i));
+    }
+
+    /* Takes O(degree), as the row is decoded up to the picked slot. */
+    template <class _Rng=MTEngine>
+    inline _NId random_neighbor(const _NId &id, _Rng &rng=default_engine()) const {
+        int i = _ids.checked(id);
+        int deg = _adj.degree(i);
+        if (deg == 0) throw NoNeighborsException<_NId>(id);
+        return _ids.ids[_adj.nth(i, rng.randi(deg))];
+    }
+
+    inline std::vector<_NId> nodes() const {
+        return _ids.ids;
+    }
+
+    inline const std::vector<_NId> &iterate_nodes() const {
+        return _ids.ids;
+    }
+
+    /* Node i has id id_of(i). Nodes are sorted by id. */
+    inline int index_of(const _NId &id) const {
+        return _ids.checked(id);
+    }
+
+    inline const _NId &id_of(int index) const {
+        return _ids.ids[index];
+    }
+
+    /* Estimated bytes of the snapshot. */
+    inline std::size_t memory_usage() const {
+        return sizeof(*this) + _ids.memory_usage() + _ndata.memory_usage()
+             + _adj.memory_usage() + _edata.memory_usage();
+    }
+
+    inline _NData &operator[](const _NId &id) {
+        return node(id);
+    }
+
+    private:
+    _SortedIds<_NId> _ids;
+    _DataColumn<_NData> _ndata;
+    _VarintAdjacency _adj;
+    _DataColumn<_EData> _edata;
+    int _n_edges;
+};
+
+
+/* Read-only compressed snapshot of a directed network */
+template <class _NId=Id, class _NData=None, class _EData=None>
+class CompressedDirectedNetwork {
+    friend std::ostream& operator<<(std::ostream& out, const CompressedDirectedNetwork& net) {
+        out << "Compressed directed network {#(node)=" << net.number_of_nodes()
+            << ", #(edge)=" << net.number_of_edges()
+            << ", #(degree)=" << net.total_degree() << "}";
+        return out;
+    }
+
+    public:
+    CompressedDirectedNetwork () : _ids(), _ndata(), _succ(), _pred(), _edata() {}
+
+    /* Build from any directed network exposing iterate_nodes,
+     * iterate_successors, iterate_predecessors, get_node_data and
+     * get_edge_data. Node ids should be ordered by operator<. */
+    template <class _Net>
+    explicit CompressedDirectedNetwork (const _Net &net)
+            : _ids(), _ndata(), _succ(), _pred(), _edata() {
+        _ids.assign_nodes(net);
+        int n = _ids.ids.size();
+        _ndata.reserve(n);
+        for (int i = 0; i < n; i++)
+            _ndata.push_back(net.get_node_data(_ids.ids[i]));
+        _ids.encode(_succ, [&](int i, std::vector<int> &row) {
+            for (auto &nei : net.iterate_successors(_ids.ids[i]))
+                row.push_back(_ids.find(nei));
+        });
+        _ids.encode(_pred, [&](int i, std::vector<int> &row) {
+            for (auto &nei : net.iterate_predecessors(_ids.ids[i]))
+                row.push_back(_ids.find(nei));
+        });
+        _edata.reserve(_succ.slots[n]);
+        for (int i = 0; i < n; i++)
+            for (auto &nei : iterate_successors(_ids.ids[i]))
+                _edata.push_back(net.get_edge_data(_ids.ids[i], nei));
+    }
+
+    /* Build from edges in [begin, end), see CompressedNetwork. */
+    template <class _Iter>
+    CompressedDirectedNetwork (_Iter begin, _Iter end)
+            : _ids(), _ndata(), _succ(), _pred(), _edata() {
+        _ids.assign_edges(begin, end);
+        int n = _ids.ids.size();
+        for (int i = 0; i < n; i++)
+            _ndata.push_back(_NData());
+        _ids.encode_edges(_succ, begin, end, true, false);
+        _ids.encode_edges(_pred, begin, end, false, true);
+        _edata.reserve(_succ.slots[n]);
+        for (std::size_t k = 0; k < _succ.slots[n]; k++)
+            _edata.push_back(_EData());
+    }
+
+    inline bool has_node(const _NId &id) const {
+        return _ids.find(id) >= 0;
+    }
+
+    inline bool has_successor(const _NId &id1, const _NId &id2) const {
+        int i = _ids.find(id1), j = _ids.find(id2);
+        if (i < 0 || j < 0) return false;
+        return _succ.slot(i, j) >= 0;
+    }
+
+    inline bool has_predecessor(const _NId &id1, const _NId &id2) const {
+        int i = _ids.find(id1), j = _ids.find(id2);
+        if (i < 0 || j < 0) return false;
+        return _pred.slot(i, j) >= 0;
+    }
+
+    inline bool has_edge(const _NId &id1, const _NId &id2) const {
+        return has_successor(id1, id2);
+    }
+
+    inline bool is_neighbor(const _NId &id1, const _NId &id2) const {
+        int i = _ids.find(id1), j = _ids.find(id2);
+        if (i < 0 || j < 0) return false;
+        return _succ.slot(i, j) >= 0 || _pred.slot(i, j) >= 0;
+    }
+
+    inline _NData &node(const _NId &id) {
+        return _ndata[_ids.checked(id)];
+    }
+
+    inline _NData get_node_data(const _NId &id) const {
+        return _ndata[_ids.checked(id)];
+    }
+
+    inline _EData get_edge_data(const _NId &id1, const _NId &id2) const {
+        long k = _succ.slot(_ids.checked(id1), _ids.checked(id2));
+        if (k < 0) throw NoEdgeException<_NId>(id1, id2, true);
+        return _edata[k];
+    }
+
+    inline int number_of_nodes() const {
+        return _ids.ids.size();
+    }
+
+    inline int number_of_edges() const {
+        return _succ.slots.back();
+    }
+
+    inline int total_degree() const {
+        return number_of_edges() * 2;
+    }
+
+    inline int in_degree(const _NId &id) const {
+        int i = _ids.find(id);
+        if (i < 0) return 0;
+        return _pred.degree(i);
+    }
+
+    inline int out_degree(const _NId &id) const {
+        int i = _ids.find(id);
+        if (i < 0) return 0;
+        return _succ.degree(i);
+    }
+
+    inline int degree(const _NId &id) const {
+        int i = _ids.find(id);
+        if (i < 0) return 0;
+        return _pred.degree(i) + _succ.degree(i);
+    }
+
+    inline std::vector<_NId> successors(const _NId &id) const {
+        return _row(_succ, id);
+    }
+
+    inline CompressedNeighborView<_NId> iterate_successors(const _NId &id) const {
+        int i = _ids.checked(id);
+        return CompressedNeighborView<_NId>(_ids.ids.data(), _succ.row(i), _succ.degree(i));
+    }
+
+    inline std::vector<_NId> predecessors(const _NId &id) const {
+        return _row(_pred, id);
+    }
+
+    inline CompressedNeighborView<_NId> iterate_predecessors(const _NId &id) const {
+        int i = _ids.checked(id);
+        return CompressedNeighborView<_NId>(_ids.ids.data(), _pred.row(i), _pred.degree(i));
+    }
+
+    /* Takes O(out_degree), see CompressedNetwork::random_neighbor. */
+    template <class _Rng=MTEngine>
+    inline _NId random_successor(const _NId &id, _Rng &rng=default_engine()) const {
+        int i = _ids.checked(id);
+        int deg = _succ.degree(i);
+        if (deg == 0) throw NoNeighborsException<_NId>(id);
+        return _ids.ids[_succ.nth(i, rng.randi(deg))];
+    }
+
+    template <class _Rng=MTEngine>
+    inline _NId random_predecessor(const _NId &id, _Rng &rng=default_engine()) const {
+        int i = _ids.checked(id);
+        int deg = _pred.degree(i);
+        if (deg == 0) throw NoNeighborsException<_NId>(id);
+        return _ids.ids[_pred.nth(i, rng.randi(deg))];
+    }
+
+    /* Sorted rows make the union a linear merge. */
+    inline std::vector<_NId> neighbors(const _NId &id) const {
+        std::vector<_NId> nei;
+        if (!has_node(id)) return nei;
+        auto succ = iterate_successors(id), pred = iterate_predecessors(id);
+        auto s = succ.begin(), se = succ.end(), p = pred.begin(), pe = pred.end();
+        while (s != se || p != pe) {
+            if (!(p != pe) || (s != se && *s < *p)) { nei.push_back(*s); ++s; }
+            else if (!(s != se) || *p < *s) { nei.push_back(*p); ++p; }
+            else { nei.push_back(*s); ++s; ++p; }
+        }
+        return nei;
+    }
+
+    inline std::vector<_NId> nodes() const {
+        return _ids.ids;
+    }
+
+    inline const std::vector<_NId> &iterate_nodes() const {
+        return _ids.ids;
+    }
+
+    /* Index level access, see CompressedNetwork. */
+    inline int index_of(const _NId &id) const {
+        return _ids.checked(id);
+    }
+
+    inline const _NId &id_of(int index) const {
+        return _ids.ids[index];
+    }
+
+    inline std::size_t memory_usage() const {
+        return sizeof(*this) + _ids.memory_usage() + _ndata.memory_usage()
+             + _succ.memory_usage() + _pred.memory_usage() + _edata.memory_usage();
+    }
+
+    inline _NData &operator[](const _NId &id) {
+        return node(id);
+    }
+
+    private:
+    inline std::vector<_NId> _row(const _VarintAdjacency &adj, const _NId &id) const {
+        std::vector<_NId> nei;
+        int i = _ids.find(id);
+        if (i >= 0)
+            for (auto &n : CompressedNeighborView<_NId>(_ids.ids.data(), adj.row(i), adj.degree(i)))
+                nei.push_back(n);
+        return nei;
+    }
+
+    _SortedIds<_NId> _ids;
+    _DataColumn<_NData> _ndata;
+    _VarintAdjacency _succ;
+    _VarintAdjacency _pred;
+    _DataColumn<_EData> _edata;
+};
+
+#endif /* ifndef CIMNET_COMPRESSED_NET */
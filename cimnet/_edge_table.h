@@ -0,0 +1,204 @@
+/*
+ * This file contains code from https://github.com/hxt-tg/cimnet
+ * and is covered under the copyright and warranty notices:
+ * "Copyright (C) 2022 CimNet Developers
+ *  Xintao Hu <hxt.taoge@gmail.com>"
+ */
+
+/*
+ *  This file contains the edge table owned by a network. Each edge is
+ *  one record (both end nodes and the edge data) stored in fixed-size
+ *  chunks, and adjacency maps refer to edges by their index in the
+ *  table instead of a heap pointer.
+ *  For further usage, check out http://doc.hxtcloud.cn.
+ */
+
+#ifndef CIMNET_EDGE_TABLE
+#define CIMNET_EDGE_TABLE
+
+#include <vector>
+#include <utility>
+
+#include "_types.h"
+
+
+/* Record of an edge */
+template <class _NId, class _EData>
+struct EdgeRecord {
+    EdgeRecord(const _NId &id1, const _NId &id2, const _EData &edge_data)
+        : first(id1), second(id2), data(edge_data) {}
+
+    inline _EData &payload() {
+        return data;
+    }
+
+    inline const _EData &payload() const {
+        return data;
+    }
+
+    _NId first;
+    _NId second;
+    _EData data;
+};
+
+/* Edges without data store no payload at all. */
+template <class _NId>
+struct EdgeRecord<_NId, None> {
+    EdgeRecord(const _NId &id1, const _NId &id2, const None &)
+        : first(id1), second(id2) {}
+
+    inline None &payload() {
+        static None none;
+        return none;
+    }
+
+    inline const None &payload() const {
+        static const None none = None();
+        return none;
+    }
+
+    _NId first;
+    _NId second;
+};
+
+
+/* Table of edge records. Chunk 0 holds records 0 to 3, chunk k (1 to
+ * 10) records 2^(k+1) to 2^(k+2)-1, and every later chunk 4096 records.
+ * Each chunk is allocated once at its full size when the first record
+ * enters it, so small tables stay small and adding edges never moves a
+ * record. Removing an edge moves the last record into the freed slot.
+ * Emptied chunks are kept for reuse until clear(). */
+template <class _NId, class _EData>
+class EdgeTable {
+    static const int FIRST_SHIFT = 2;
+    static const int CHUNK_SHIFT = 12;
+    static const int CHUNK_SIZE = 1 << CHUNK_SHIFT;
+    static const int CHUNK_MASK = CHUNK_SIZE - 1;
+    static const int SMALL_CHUNKS = CHUNK_SHIFT - FIRST_SHIFT + 1;
+
+    public:
+    typedef EdgeRecord<_NId, _EData> _RecordType;
+
+    EdgeTable () : _chunks(), _size(0) {}
+
+    EdgeTable (const EdgeTable &other) : _chunks(), _size(0) {
+        *this = other;
+    }
+
+    EdgeTable (EdgeTable &&other) noexcept : _chunks(std::move(other._chunks)), _size(other._size) {
+        other.clear();
+    }
+
+    /* Copy the chunks holding records, each at its full size. */
+    EdgeTable &operator=(const EdgeTable &other) {
+        if (this == &other) return *this;
+        clear();
+        _chunks.resize(other._size > 0 ? _chunk(other._size - 1) + 1 : 0);
+        for (std::size_t c = 0; c < _chunks.size(); c++) {
+            _chunks[c].reserve(_chunk_size(c));
+            _chunks[c].assign(other._chunks[c].begin(), other._chunks[c].end());
+        }
+        _size = other._size;
+        return *this;
+    }
+
+    EdgeTable &operator=(EdgeTable &&other) noexcept {
+        if (this == &other) return *this;
+        _chunks = std::move(other._chunks);
+        _size = other._size;
+        other.clear();
+        return *this;
+    }
+
+    /* Append an edge and return its index. */
+    inline int insert(const _NId &id1, const _NId &id2, const _EData &edge_data) {
+        return _push(_RecordType(id1, id2, edge_data));
+    }
+
+    /* Remove the edge at index. Return true if the last record was
+     * moved to index, in which case references to it must be updated. */
+    inline bool remove(int index) {
+        int last = _size - 1;
+        if (index != last)
+            record(index) = std::move(record(last));
+        _chunks[_chunk(last)].pop_back();
+        _size = last;
+        return index != last;
+    }
+
+    inline _RecordType &record(int index) {
+        return _chunks[_chunk(index)][_offset(index)];
+    }
+
+    inline const _RecordType &record(int index) const {
+        return _chunks[_chunk(index)][_offset(index)];
+    }
+
+    inline _EData &data(int index) {
+        return record(index).payload();
+    }
+
+    inline const _EData &data(int index) const {
+        return record(index).payload();
+    }
+
+    inline int size() const {
+        return _size;
+    }
+
+    /* Number of records the allocated chunks can hold. Every chunk is
+     * allocated at its full size, so chunks 0 to c-1 hold 2^(c+1)
+     * records while they are small. */
+    inline int capacity() const {
+        int c = _chunks.size();
+        if (c <= SMALL_CHUNKS) return c > 0 ? 1 << (c + FIRST_SHIFT - 1) : 0;
+        return (c - SMALL_CHUNKS + 1) * CHUNK_SIZE;
+    }
+
+    inline void clear() noexcept {
+        std::vector<std::vector<_RecordType>>().swap(_chunks);
+        _size = 0;
+    }
+
+    private:
+    static inline int _log2(unsigned x) {
+#if defined(__GNUC__)
+        return 31 - __builtin_clz(x);
+#else
+        int k = 0;
+        while (x >>= 1) k++;
+        return k;
+#endif
+    }
+
+    static inline int _chunk(int index) {
+        if (index >= CHUNK_SIZE) return (index >> CHUNK_SHIFT) + SMALL_CHUNKS - 1;
+        if (index < (1 << FIRST_SHIFT)) return 0;
+        return _log2(index) - FIRST_SHIFT + 1;
+    }
+
+    static inline int _offset(int index) {
+        if (index >= CHUNK_SIZE) return index & CHUNK_MASK;
+        if (index < (1 << FIRST_SHIFT)) return index;
+        return index ^ (1 << _log2(index));
+    }
+
+    static inline std::size_t _chunk_size(std::size_t c) {
+        if (c >= SMALL_CHUNKS) return CHUNK_SIZE;
+        return std::size_t(1) << (c > 0 ? c + FIRST_SHIFT - 1 : FIRST_SHIFT);
+    }
+
+    inline int _push(const _RecordType &rec) {
+        std::size_t c = _chunk(_size);
+        if (c == _chunks.size()) _chunks.push_back(std::vector<_RecordType>());
+        std::vector<_RecordType> &chunk = _chunks[c];
+        if (chunk.capacity() == 0) chunk.reserve(_chunk_size(c));
+        chunk.push_back(rec);
+        return _size++;
+    }
+
+    std::vector<std::vector<_RecordType>> _chunks;
+    int _size;
+};
+
+#endif /* ifndef CIMNET_EDGE_TABLE */
@@ -0,0 +1,521 @@
+/*
+ * This file contains code from https://github.com/hxt-tg/cimnet
+ * and is covered under the copyright and warranty notices:
+ * "Copyright (C) 2022 CimNet Developers
+ *  Xintao Hu <hxt.taoge@gmail.com>"
+ */
+
+/*
+ *  This file contains read-only snapshots of networks stored in
+ *  compressed sparse row (CSR) form. Nodes are remapped to indices
+ *  0 to n-1 and neighbors of node i are targets[offsets[i]] to
+ *  targets[offsets[i+1]-1], sorted by index.
+ *  For further usage, check out http://doc.hxtcloud.cn.
+ */
+
+#ifndef CIMNET_FROZEN_NET
+#define CIMNET_FROZEN_NET
+
+#include <unordered_map>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+
+#include "_types.h"
+#include "_exception.h"
+#include "random.h"
+#include "_intersect.h"
+
+
+/* Frozen neighbor view */
+template<class _NId>
+class FrozenNeighborViewIterator {
+public:
+    FrozenNeighborViewIterator(const _NId *ids, const int *target) : _ids{ids}, _target{target} {}
+
+    bool operator!=(const FrozenNeighborViewIterator &other) const {
+        return _target != other._target;
+    }
+
+    const _NId &operator*() const {
+        return _ids[*_target];
+    }
+
+    const FrozenNeighborViewIterator &operator++() {
+        ++_target;
+        return *this;
+    }
+
+private:
+    const _NId *_ids{};
+    const int *_target{};
+};
+
+template<class _NId>
+class FrozenNeighborView {
+public:
+    using _FrozenNeighborViewIterator = FrozenNeighborViewIterator<_NId>;
+
+    FrozenNeighborView(const _NId *ids, const int *target_begin, const int *target_end)
+            : _ids(ids), _begin(target_begin), _end(target_end) {}
+
+    _FrozenNeighborViewIterator begin() const {
+        return _FrozenNeighborViewIterator(_ids, _begin);
+    }
+
+    _FrozenNeighborViewIterator end() const {
+        return _FrozenNeighborViewIterator(_ids, _end);
+    }
+
+private:
+    const _NId *_ids{};
+    const int *_begin{};
+    const int *_end{};
+};
+
+
+/* Shared CSR helpers */
+class _CSRAdjacency {
+    public:
+    inline int degree(int i) const {
+        return (int)(offsets[i + 1] - offsets[i]);
+    }
+
+    inline const int *row_begin(int i) const {
+        return targets.data() + offsets[i];
+    }
+
+    inline const int *row_end(int i) const {
+        return targets.data() + offsets[i + 1];
+    }
+
+    /* Slot of j in the sorted row of i, or -1 if absent. */
+    inline long slot(int i, int j) const {
+        const int *b = row_begin(i), *e = row_end(i);
+        const int *p = std::lower_bound(b, e, j);
+        if (p == e || *p != j) return -1;
+        return p - targets.data();
+    }
+
+    std::vector<std::size_t> offsets;
+    std::vector<int> targets;
+};
+
+
+/* Read-only CSR snapshot of an undirected network */
+template <class _NId=Id, class _NData=None, class _EData=None>
+class FrozenNetwork {
+    friend std::ostream& operator<<(std::ostream& out, const FrozenNetwork& net) {
+        out << "Frozen network {#(node)=" << net.number_of_nodes()
+            << ", #(edge)=" << net.number_of_edges()
+            << ", #(degree)=" << net.total_degree() << "}";
+        return out;
+    }
+
+    public:
+    FrozenNetwork () : _ids(), _index(), _ndata(), _adj(), _edata(), _n_edges(0) {}
+
+    /* Build from any undirected network exposing iterate_nodes,
+     * iterate_neighbors, get_node_data and get_edge_data. */
+    template <class _Net>
+    explicit FrozenNetwork (const _Net &net)
+            : _ids(), _index(), _ndata(), _adj(), _edata(), _n_edges(net.number_of_edges()) {
+        int n = net.number_of_nodes();
+        _ids.reserve(n);
+        _ndata.reserve(n);
+        _index.reserve(n);
+        for (auto &id : net.iterate_nodes()) {
+            _index[id] = (int)_ids.size();
+            _ids.push_back(id);
+            _ndata.push_back(net.get_node_data(id));
+        }
+        _adj.offsets.assign(n + 1, 0);
+        for (int i = 0; i < n; i++)
+            _adj.offsets[i + 1] = _adj.offsets[i] + net.degree(_ids[i]);
+        _adj.targets.resize(_adj.offsets[n]);
+        _edata.resize(_adj.offsets[n]);
+        for (int i = 0; i < n; i++) {
+            std::size_t k = _adj.offsets[i];
+            for (auto &nei : net.iterate_neighbors(_ids[i]))
+                _adj.targets[k++] = _index.at(nei);
+            std::sort(_adj.targets.begin() + _adj.offsets[i], _adj.targets.begin() + k);
+            for (k = _adj.offsets[i]; k < _adj.offsets[i + 1]; k++)
+                _edata[k] = net.get_edge_data(_ids[i], _ids[_adj.targets[k]]);
+        }
+    }
+
+    inline bool has_node(const _NId &id) const {
+        return _find(id) >= 0;
+    }
+
+    inline bool has_edge(const _NId &id1, const _NId &id2) const {
+        int i = _find(id1), j = _find(id2);
+        if (i < 0 || j < 0) return false;
+        return _adj.slot(i, j) >= 0;
+    }
+
+    inline bool is_neighbor(const _NId &id1, const _NId &id2) const {
+        return has_edge(id1, id2);
+    }
+
+    inline _NData &node(const _NId &id) {
+        return _ndata[_checked(id)];
+    }
+
+    inline _NData get_node_data(const _NId &id) const {
+        return _ndata[_checked(id)];
+    }
+
+    inline _EData get_edge_data(const _NId &id1, const _NId &id2) const {
+        long k = _adj.slot(_checked(id1), _checked(id2));
+        if (k < 0) throw NoEdgeException<_NId>(id1, id2);
+        return _edata[k];
+    }
+
+    inline int number_of_nodes() const {
+        return _ids.size();
+    }
+
+    inline int number_of_edges() const {
+        return _n_edges;
+    }
+
+    inline int total_degree() const {
+        return _adj.targets.size();
+    }
+
+    inline int degree(const _NId &id) const {
+        int i = _find(id);
+        if (i < 0) return 0;
+        return _adj.degree(i);
+    }
+
+    inline std::vector<_NId> neighbors(const _NId &id) const {
+        std::vector<_NId> nei;
+        int i = _find(id);
+        if (i >= 0)
+            for (const int *p = _adj.row_begin(i); p != _adj.row_end(i); ++p)
+                nei.push_back(_ids[*p]);
+        return nei;
+    }
+
+    inline FrozenNeighborView<_NId> iterate_neighbors(const _NId &id) const {
+        int i = _checked(id);
+        return FrozenNeighborView<_NId>(_ids.data(), _adj.row_begin(i), _adj.row_end(i));
+    }
+
+    template <class _Rng=MTEngine>
+    inline _NId random_neighbor(const _NId &id, _Rng &rng=default_engine()) const {
+        int i = _checked(id);
+        int deg = _adj.degree(i);
+        if (deg == 0) throw NoNeighborsException<_NId>(id);
+        return _ids[_adj.row_begin(i)[rng.randi(deg)]];
+    }
+
+    /* Neighbors of both id1 and id2, see Network::common_neighbors. */
+    inline std::vector<_NId> common_neighbors(const _NId &id1, const _NId &id2) const {
+        std::vector<_NId> nei;
+        int i = _find(id1), j = _find(id2);
+        if (i >= 0 && j >= 0)
+            _intersect_ints(_adj.row_begin(i), _adj.row_end(i), _adj.row_begin(j), _adj.row_end(j),
+                    [&](int k) { nei.push_back(_ids[k]); });
+        return nei;
+    }
+
+    inline int count_common_neighbors(const _NId &id1, const _NId &id2) const {
+        int n = 0;
+        int i = _find(id1), j = _find(id2);
+        if (i >= 0 && j >= 0)
+            _intersect_ints(_adj.row_begin(i), _adj.row_end(i), _adj.row_begin(j), _adj.row_end(j),
+                    [&](int) { ++n; });
+        return n;
+    }
+
+    inline std::vector<_NId> nodes() const {
+        return _ids;
+    }
+
+    inline const std::vector<_NId> &iterate_nodes() const {
+        return _ids;
+    }
+
+    /* Index level access. Node i has id id_of(i), its neighbors are
+     * targets()[offsets()[i]] to targets()[offsets()[i+1]-1]. */
+    inline int index_of(const _NId &id) const {
+        return _checked(id);
+    }
+
+    inline const _NId &id_of(int index) const {
+        return _ids[index];
+    }
+
+    inline const std::vector<std::size_t> &offsets() const {
+        return _adj.offsets;
+    }
+
+    inline const std::vector<int> &targets() const {
+        return _adj.targets;
+    }
+
+    inline _NData &operator[](const _NId &id) {
+        return node(id);
+    }
+
+    private:
+    inline int _find(const _NId &id) const {
+        auto it = _index.find(id);
+        return it == _index.end() ? -1 : it->second;
+    }
+
+    inline int _checked(const _NId &id) const {
+        int i = _find(id);
+        if (i < 0) throw NoNodeException<_NId>(id);
+        return i;
+    }
+
+    std::vector<_NId> _ids;
+    std::unordered_map<_NId, int> _index;
+    std::vector<_NData> _ndata;
+    _CSRAdjacency _adj;
+    std::vector<_EData> _edata;
+    int _n_edges;
+};
+
+
+/* Read-only CSR snapshot of a directed network */
+template <class _NId=Id, class _NData=None, class _EData=None>
+class FrozenDirectedNetwork {
+    friend std::ostream& operator<<(std::ostream& out, const FrozenDirectedNetwork& net) {
+        out << "Frozen directed network {#(node)=" << net.number_of_nodes()
+            << ", #(edge)=" << net.number_of_edges()
+            << ", #(degree)=" << net.total_degree() << "}";
+        return out;
+    }
+
+    public:
+    FrozenDirectedNetwork () : _ids(), _index(), _ndata(), _succ(), _pred(), _edata() {}
+
+    /* Build from any directed network exposing iterate_nodes,
+     * iterate_successors, iterate_predecessors, get_node_data
+     * and get_edge_data. */
+    template <class _Net>
+    explicit FrozenDirectedNetwork (const _Net &net)
+            : _ids(), _index(), _ndata(), _succ(), _pred(), _edata() {
+        int n = net.number_of_nodes();
+        _ids.reserve(n);
+        _ndata.reserve(n);
+        _index.reserve(n);
+        for (auto &id : net.iterate_nodes()) {
+            _index[id] = (int)_ids.size();
+            _ids.push_back(id);
+            _ndata.push_back(net.get_node_data(id));
+        }
+        _succ.offsets.assign(n + 1, 0);
+        _pred.offsets.assign(n + 1, 0);
+        for (int i = 0; i < n; i++) {
+            _succ.offsets[i + 1] = _succ.offsets[i] + net.out_degree(_ids[i]);
+            _pred.offsets[i + 1] = _pred.offsets[i] + net.in_degree(_ids[i]);
+        }
+        _succ.targets.resize(_succ.offsets[n]);
+        _pred.targets.resize(_pred.offsets[n]);
+        _edata.resize(_succ.offsets[n]);
+        for (int i = 0; i < n; i++) {
+            std::size_t k = _succ.offsets[i];
+            for (auto &nei : net.iterate_successors(_ids[i]))
+                _succ.targets[k++] = _index.at(nei);
+            std::sort(_succ.targets.begin() + _succ.offsets[i], _succ.targets.begin() + k);
+            for (k = _succ.offsets[i]; k < _succ.offsets[i + 1]; k++)
+                _edata[k] = net.get_edge_data(_ids[i], _ids[_succ.targets[k]]);
+            k = _pred.offsets[i];
+            for (auto &nei : net.iterate_predecessors(_ids[i]))
+                _pred.targets[k++] = _index.at(nei);
+            std::sort(_pred.targets.begin() + _pred.offsets[i], _pred.targets.begin() + k);
+        }
+    }
+
+    inline bool has_node(const _NId &id) const {
+        return _find(id) >= 0;
+    }
+
+    inline bool has_successor(const _NId &id1, const _NId &id2) const {
+        int i = _find(id1), j = _find(id2);
+        if (i < 0 || j < 0) return false;
+        return _succ.slot(i, j) >= 0;
+    }
+
+    inline bool has_predecessor(const _NId &id1, const _NId &id2) const {
+        int i = _find(id1), j = _find(id2);
+        if (i < 0 || j < 0) return false;
+        return _pred.slot(i, j) >= 0;
+    }
+
+    inline bool has_edge(const _NId &id1, const _NId &id2) const {
+        return has_successor(id1, id2);
+    }
+
+    inline bool is_neighbor(const _NId &id1, const _NId &id2) const {
+        int i = _find(id1), j = _find(id2);
+        if (i < 0 || j < 0) return false;
+        return _succ.slot(i, j) >= 0 || _pred.slot(i, j) >= 0;
+    }
+
+    inline _NData &node(const _NId &id) {
+        return _ndata[_checked(id)];
+    }
+
+    inline _NData get_node_data(const _NId &id) const {
+        return _ndata[_checked(id)];
+    }
+
+    inline _EData get_edge_data(const _NId &id1, const _NId &id2) const {
+        long k = _succ.slot(_checked(id1), _checked(id2));
+        if (k < 0) throw NoEdgeException<_NId>(id1, id2, true);
+        return _edata[k];
+    }
+
+    inline int number_of_nodes() const {
+        return _ids.size();
+    }
+
+    inline int number_of_edges() const {
+        return _succ.targets.size();
+    }
+
+    inline int total_degree() const {
+        return number_of_edges() * 2;
+    }
+
+    inline int in_degree(const _NId &id) const {
+        int i = _find(id);
+        if (i < 0) return 0;
+        return _pred.degree(i);
+    }
+
+    inline int out_degree(const _NId &id) const {
+        int i = _find(id);
+        if (i < 0) return 0;
+        return _succ.degree(i);
+    }
+
+    inline int degree(const _NId &id) const {
+        int i = _find(id);
+        if (i < 0) return 0;
+        return _pred.degree(i) + _succ.degree(i);
+    }
+
+    inline std::vector<_NId> successors(const _NId &id) const {
+        return _row(_succ, id);
+    }
+
+    inline FrozenNeighborView<_NId> iterate_successors(const _NId &id) const {
+        int i = _checked(id);
+        return FrozenNeighborView<_NId>(_ids.data(), _succ.row_begin(i), _succ.row_end(i));
+    }
+
+    inline std::vector<_NId> predecessors(const _NId &id) const {
+        return _row(_pred, id);
+    }
+
+    inline FrozenNeighborView<_NId> iterate_predecessors(const _NId &id) const {
+        int i = _checked(id);
+        return FrozenNeighborView<_NId>(_ids.data(), _pred.row_begin(i), _pred.row_end(i));
+    }
+
+    template <class _Rng=MTEngine>
+    inline _NId random_successor(const _NId &id, _Rng &rng=default_engine()) const {
+        int i = _checked(id);
+        int deg = _succ.degree(i);
+        if (deg == 0) throw NoNeighborsException<_NId>(id);
+        return _ids[_succ.row_begin(i)[rng.randi(deg)]];
+    }
+
+    template <class _Rng=MTEngine>
+    inline _NId random_predecessor(const _NId &id, _Rng &rng=default_engine()) const {
+        int i = _checked(id);
+        int deg = _pred.degree(i);
+        if (deg == 0) throw NoNeighborsException<_NId>(id);
+        return _ids[_pred.row_begin(i)[rng.randi(deg)]];
+    }
+
+    /* Sorted rows make the union a linear merge. */
+    inline std::vector<_NId> neighbors(const _NId &id) const {
+        std::vector<_NId> nei;
+        int i = _find(id);
+        if (i < 0) return nei;
+        const int *s = _succ.row_begin(i), *se = _succ.row_end(i);
+        const int *p = _pred.row_begin(i), *pe = _pred.row_end(i);
+        while (s != se || p != pe) {
+            if (p == pe || (s != se && *s < *p)) nei.push_back(_ids[*s++]);
+            else if (s == se || *p < *s) nei.push_back(_ids[*p++]);
+            else { nei.push_back(_ids[*s++]); ++p; }
+        }
+        return nei;
+    }
+
+    inline std::vector<_NId> nodes() const {
+        return _ids;
+    }
+
+    inline const std::vector<_NId> &iterate_nodes() const {
+        return _ids;
+    }
+
+    /* Index level access, see FrozenNetwork. */
+    inline int index_of(const _NId &id) const {
+        return _checked(id);
+    }
+
+    inline const _NId &id_of(int index) const {
+        return _ids[index];
+    }
+
+    inline const std::vector<std::size_t> &succ_offsets() const {
+        return _succ.offsets;
+    }
+
+    inline const std::vector<int> &succ_targets() const {
+        return _succ.targets;
+    }
+
+    inline const std::vector<std::size_t> &pred_offsets() const {
+        return _pred.offsets;
+    }
+
+    inline const std::vector<int> &pred_targets() const {
+        return _pred.targets;
+    }
+
+    inline _NData &operator[](const _NId &id) {
+        return node(id);
+    }
+
+    private:
+    inline int _find(const _NId &id) const {
+        auto it = _index.find(id);
+        return it == _index.end() ? -1 : it->second;
+    }
+
+    inline int _checked(const _NId &id) const {
+        int i = _find(id);
+        if (i < 0) throw NoNodeException<_NId>(id);
+        return i;
+    }
+
+    inline std::vector<_NId> _row(const _CSRAdjacency &adj, const _NId &id) const {
+        std::vector<_NId> nei;
+        int i = _find(id);
+        if (i >= 0)
+            for (const int *p = adj.row_begin(i); p != adj.row_end(i); ++p)
+                nei.push_back(_ids[*p]);
+        return nei;
+    }
+
+    std::vector<_NId> _ids;
+    std::unordered_map<_NId, int> _index;
+    std::vector<_NData> _ndata;
+    _CSRAdjacency _succ;
+    _CSRAdjacency _pred;
+    std::vector<_EData> _edata;
+};
+
+#endif /* ifndef CIMNET_FROZEN_NET */
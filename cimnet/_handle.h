@@ -0,0 +1,291 @@
+/*
+ * This file contains code from https://github.com/hxt-tg/cimnet
+ * and is covered under the copyright and warranty notices:
+ * "Copyright (C) 2022 CimNet Developers
+ *  Xintao Hu <hxt.taoge@gmail.com>"
+ */
+
+/*
+ *  This file contains handles of nodes and edges. A handle is resolved
+ *  once by Network::node_handle or edge_handle, and then reaches node
+ *  data, neighbors and edge data without any lookup or check.
+ *
+ *  A node handle stays valid until its node is removed, and with
+ *  DenseStorage also until a node with a larger id is added. An edge
+ *  handle stays valid until any edge is removed; adding edges never
+ *  moves edge records. Using an invalid
+ *  handle is undefined, unless CIMNET_CHECK_HANDLES is defined before
+ *  including CimNet, in which case every access verifies the handle and
+ *  throws NetworkException if it is invalid.
+ *  For further usage, check out http://doc.hxtcloud.cn.
+ */
+
+#ifndef CIMNET_HANDLE
+#define CIMNET_HANDLE
+
+#include "_types.h"
+#include "_exception.h"
+#include "_storage.h"
+#include "_edge_table.h"
+#include "random.h"
+
+
+template<class _NId, class _NData, class _EData, class _Storage>
+class NeighborView;
+
+
+/* Handle of a node of an undirected network */
+template <class _NId, class _NData, class _EData, class _Storage=HashStorage>
+class NodeHandle {
+public:
+    using _NType = typename _Storage::template NodeMap<_NId, _NData>;
+    using _NeiType = typename _Storage::template NeighborMap<_NId, int>;
+    using _AdjType = typename _Storage::template NodeMap<_NId, _NeiType>;
+    using _ETableType = EdgeTable<_NId, _EData>;
+
+    NodeHandle(const _NId &id, _NData *data, _NeiType *nei, _ETableType *edges,
+            const _NType *nodes, const _AdjType *adjs)
+            : _id(id), _data(data), _nei(nei), _edges(edges), _nodes(nodes), _adjs(adjs) {}
+
+    const _NId &id() const {
+        return _id;
+    }
+
+    _NData &data() const {
+        _check();
+        return *_data;
+    }
+
+    int degree() const {
+        _check();
+        return _nei->size();
+    }
+
+    /* The i-th neighbor, 0 <= i < degree(). */
+    const _NId &neighbor(int i) const {
+        _check();
+        return _nei->nth(i).first;
+    }
+
+    /* Data of the edge to the i-th neighbor. */
+    _EData &edge_data(int i) const {
+        _check();
+        return _edges->data(_nei->nth(i).second);
+    }
+
+    /* Data of the edge to id, with one lookup. */
+    _EData &edge_to(const _NId &id) const {
+        _check();
+        auto it = _nei->find(id);
+        if (it == _nei->end()) throw NoEdgeException<_NId>(_id, id);
+        return _edges->data(it->second);
+    }
+
+    bool has_neighbor(const _NId &id) const {
+        _check();
+        return _nei->find(id) != _nei->end();
+    }
+
+    NeighborView<_NId, _NData, _EData, _Storage> iterate_neighbors() const {
+        _check();
+        return NeighborView<_NId, _NData, _EData, _Storage>(_nei->begin(), _nei->end());
+    }
+
+    template <class _Rng=MTEngine>
+    _NId random_neighbor(_Rng &rng=default_engine()) const {
+        int deg = degree();
+        if (deg == 0) throw NoNeighborsException<_NId>(_id);
+        return _nei->nth(rng.randi(deg)).first;
+    }
+
+private:
+    void _check() const {
+#ifdef CIMNET_CHECK_HANDLES
+        auto n = _nodes->find(_id);
+        auto a = _adjs->find(_id);
+        if (n == _nodes->end() || &n->second != _data || &a->second != _nei)
+            throw NetworkException("Invalid node handle.");
+#endif
+    }
+
+    _NId _id;
+    _NData *_data;
+    _NeiType *_nei;
+    _ETableType *_edges;
+    const _NType *_nodes;
+    const _AdjType *_adjs;
+};
+
+
+/* Handle of a node of a directed network */
+template <class _NId, class _NData, class _EData, class _Storage=HashStorage>
+class DiNodeHandle {
+public:
+    using _NType = typename _Storage::template NodeMap<_NId, _NData>;
+    using _NeiType = typename _Storage::template NeighborMap<_NId, int>;
+    using _AdjType = typename _Storage::template NodeMap<_NId, _NeiType>;
+    using _ETableType = EdgeTable<_NId, _EData>;
+
+    DiNodeHandle(const _NId &id, _NData *data, _NeiType *succ, _NeiType *pred, _ETableType *edges,
+            const _NType *nodes, const _AdjType *succ_adjs)
+            : _id(id), _data(data), _succ(succ), _pred(pred), _edges(edges),
+              _nodes(nodes), _succ_adjs(succ_adjs) {}
+
+    const _NId &id() const {
+        return _id;
+    }
+
+    _NData &data() const {
+        _check();
+        return *_data;
+    }
+
+    int out_degree() const {
+        _check();
+        return _succ->size();
+    }
+
+    int in_degree() const {
+        _check();
+        return _pred->size();
+    }
+
+    int degree() const {
+        return out_degree() + in_degree();
+    }
+
+    /* The i-th successor, 0 <= i < out_degree(). */
+    const _NId &successor(int i) const {
+        _check();
+        return _succ->nth(i).first;
+    }
+
+    /* The i-th predecessor, 0 <= i < in_degree(). */
+    const _NId &predecessor(int i) const {
+        _check();
+        return _pred->nth(i).first;
+    }
+
+    /* Data of the edge to the i-th successor. */
+    _EData &out_edge_data(int i) const {
+        _check();
+        return _edges->data(_succ->nth(i).second);
+    }
+
+    /* Data of the edge from the i-th predecessor. */
+    _EData &in_edge_data(int i) const {
+        _check();
+        return _edges->data(_pred->nth(i).second);
+    }
+
+    /* Data of the edge to id, with one lookup. */
+    _EData &edge_to(const _NId &id) const {
+        _check();
+        auto it = _succ->find(id);
+        if (it == _succ->end()) throw NoEdgeException<_NId>(_id, id, true);
+        return _edges->data(it->second);
+    }
+
+    bool has_successor(const _NId &id) const {
+        _check();
+        return _succ->find(id) != _succ->end();
+    }
+
+    bool has_predecessor(const _NId &id) const {
+        _check();
+        return _pred->find(id) != _pred->end();
+    }
+
+    NeighborView<_NId, _NData, _EData, _Storage> iterate_successors() const {
+        _check();
+        return NeighborView<_NId, _NData, _EData, _Storage>(_succ->begin(), _succ->end());
+    }
+
+    NeighborView<_NId, _NData, _EData, _Storage> iterate_predecessors() const {
+        _check();
+        return NeighborView<_NId, _NData, _EData, _Storage>(_pred->begin(), _pred->end());
+    }
+
+    template <class _Rng=MTEngine>
+    _NId random_successor(_Rng &rng=default_engine()) const {
+        int deg = out_degree();
+        if (deg == 0) throw NoNeighborsException<_NId>(_id);
+        return _succ->nth(rng.randi(deg)).first;
+    }
+
+    template <class _Rng=MTEngine>
+    _NId random_predecessor(_Rng &rng=default_engine()) const {
+        int deg = in_degree();
+        if (deg == 0) throw NoNeighborsException<_NId>(_id);
+        return _pred->nth(rng.randi(deg)).first;
+    }
+
+private:
+    void _check() const {
+#ifdef CIMNET_CHECK_HANDLES
+        auto n = _nodes->find(_id);
+        auto s = _succ_adjs->find(_id);
+        if (n == _nodes->end() || &n->second != _data || &s->second != _succ)
+            throw NetworkException("Invalid node handle.");
+#endif
+    }
+
+    _NId _id;
+    _NData *_data;
+    _NeiType *_succ;
+    _NeiType *_pred;
+    _ETableType *_edges;
+    const _NType *_nodes;
+    const _AdjType *_succ_adjs;
+};
+
+
+/* Handle of an edge */
+template <class _NId, class _EData>
+class EdgeHandle {
+public:
+    using _ETableType = EdgeTable<_NId, _EData>;
+
+    EdgeHandle(_ETableType *edges, int index)
+            : _rec(&edges->record(index))
+#ifdef CIMNET_CHECK_HANDLES
+            , _edges(edges), _index(index), _id1(_rec->first), _id2(_rec->second)
+#endif
+    {}
+
+    /* End nodes in the order the edge was added. */
+    const _NId &first() const {
+        _check();
+        return _rec->first;
+    }
+
+    const _NId &second() const {
+        _check();
+        return _rec->second;
+    }
+
+    _EData &data() const {
+        _check();
+        return _rec->payload();
+    }
+
+private:
+    void _check() const {
+#ifdef CIMNET_CHECK_HANDLES
+        /* A removal moves the last record into the freed slot. */
+        if (_index >= _edges->size() || &_edges->record(_index) != _rec
+                || !(_rec->first == _id1 && _rec->second == _id2))
+            throw NetworkException("Invalid edge handle.");
+#endif
+    }
+
+    EdgeRecord<_NId, _EData> *_rec;
+#ifdef CIMNET_CHECK_HANDLES
+    _ETableType *_edges;
+    int _index;
+    _NId _id1;
+    _NId _id2;
+#endif
+};
+
+#endif /* ifndef CIMNET_HANDLE */
@@ -0,0 +1,134 @@
+/*
+ * This file contains code from https://github.com/hxt-tg/cimnet
+ * and is covered under the copyright and warranty notices:
+ * "Copyright (C) 2022 CimNet Developers
+ *  Xintao Hu <hxt.taoge@gmail.com>"
+ */
+
+/*
+ *  This file contains intersection of neighbor lists, used to find
+ *  common neighbors. Sorted lists of similar length are merged, and a
+ *  list much shorter than the other gallops through it (exponential
+ *  then binary search), taking O(m log(n/m)). Sorted int arrays (rows
+ *  of frozen networks) are merged four by four with SSE2 when it is
+ *  available. Unsorted maps probe the larger map with each key of the
+ *  smaller one.
+ *  For further usage, check out http://doc.hxtcloud.cn.
+ */
+
+#ifndef CIMNET_INTERSECT
+#define CIMNET_INTERSECT
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "_storage.h"
+
+
+/* Gallop when one list is this many times longer than the other. */
+const int _GALLOP_RATIO = 32;
+
+/* Call f(x) for every item x of [a, a_end) whose key is also the key
+ * of an item of [b, b_end). Both ranges are sorted by key(item) and
+ * free of repeats. */
+template <class _Iter, class _Key, class _Func>
+inline void _gallop(_Iter a, _Iter a_end, _Iter b, _Iter b_end, _Key key, _Func f) {
+    for (; a != a_end && b != b_end; ++a) {
+        auto k = key(*a);
+        long step = 1;
+        while (step < b_end - b && key(b[step]) < k)
+            step *= 2;
+        _Iter hi = step < b_end - b ? b + step + 1 : b_end;
+        b = std::lower_bound(b + step / 2, hi, k,
+                [&](const typename std::iterator_traits<_Iter>::value_type &x, const decltype(k) &y) {
+                    return key(x) < y;
+                });
+        if (b != b_end && !(k < key(*b))) {
+            f(*a);
+            ++b;
+        }
+    }
+}
+
+template <class _Iter, class _Key, class _Func>
+inline void _merge(_Iter a, _Iter a_end, _Iter b, _Iter b_end, _Key key, _Func f) {
+    while (a != a_end && b != b_end) {
+        if (key(*a) < key(*b)) ++a;
+        else if (key(*b) < key(*a)) ++b;
+        else {
+            f(*a);
+            ++a;
+            ++b;
+        }
+    }
+}
+
+/* Call f(x) for items of both sorted ranges, see _gallop. */
+template <class _Iter, class _Key, class _Func>
+inline void _intersect_sorted(_Iter a, _Iter a_end, _Iter b, _Iter b_end, _Key key, _Func f) {
+    if (a_end - a > b_end - b) {
+        std::swap(a, b);
+        std::swap(a_end, b_end);
+    }
+    if (b_end - b > _GALLOP_RATIO * (a_end - a))
+        _gallop(a, a_end, b, b_end, key, f);
+    else
+        _merge(a, a_end, b, b_end, key, f);
+}
+
+/* Call f(x) for ints of both sorted arrays. */
+template <class _Func>
+inline void _intersect_ints(const int *a, const int *a_end, const int *b, const int *b_end, _Func f) {
+    auto key = [](int x) { return x; };
+    if (a_end - a > b_end - b) {
+        std::swap(a, b);
+        std::swap(a_end, b_end);
+    }
+    if (b_end - b > _GALLOP_RATIO * (a_end - a)) {
+        _gallop(a, a_end, b, b_end, key, f);
+        return;
+    }
+#if defined(__SSE2__)
+    /* Compare four items of a with four of b in all rotations, then
+     * move past the block with the smaller maximum (or both). */
+    while (a_end - a >= 4 && b_end - b >= 4) {
+        __m128i va = _mm_loadu_si128((const __m128i *)a);
+        __m128i vb = _mm_loadu_si128((const __m128i *)b);
+        __m128i eq = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi32(va, vb),
+                             _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+                _mm_or_si128(_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))),
+                             _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)))));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(eq));
+        for (int i = 0; mask; i++, mask >>= 1)
+            if (mask & 1) f(a[i]);
+        int a_max = a[3], b_max = b[3];
+        if (a_max <= b_max) a += 4;
+        if (b_max <= a_max) b += 4;
+    }
+#endif
+    _merge(a, a_end, b, b_end, key, f);
+}
+
+/* Call f(key) for keys in both neighbor maps. */
+template <class _K, class _V, class _Func>
+inline void _common_keys(const SortedMap<_K, _V> &a, const SortedMap<_K, _V> &b, _Func f) {
+    _intersect_sorted(a.begin(), a.end(), b.begin(), b.end(),
+            [](const std::pair<_K, _V> &x) -> const _K & { return x.first; },
+            [&](const std::pair<_K, _V> &x) { f(x.first); });
+}
+
+template <class _Map, class _Func>
+inline void _common_keys(const _Map &a, const _Map &b, _Func f) {
+    const _Map &small = a.size() <= b.size() ? a : b;
+    const _Map &large = a.size() <= b.size() ? b : a;
+    for (auto &x : small)
+        if (large.count(x.first)) f(x.first);
+}
+
+#endif /* ifndef CIMNET_INTERSECT */
@@ -0,0 +1,196 @@
+/*
+ * This file contains code from https://github.com/hxt-tg/cimnet
+ * and is covered under the copyright and warranty notices:
+ * "Copyright (C) 2022 CimNet Developers
+ *  Xintao Hu <hxt.taoge@gmail.com>"
+ */
+
+/*
+ *  This file contains memory and container statistics of networks.
+ *  Byte counts are estimates: they follow the layout of the standard
+ *  library containers (one heap node per hash table item plus the
+ *  bucket array) with the usual malloc header and 16-byte alignment,
+ *  and do not include memory owned by ids or data themselves (such as
+ *  the characters of a std::string).
+ *  For further usage, check out http://doc.hxtcloud.cn.
+ */
+
+#ifndef CIMNET_STATS
+#define CIMNET_STATS
+
+#include <unordered_map>
+#include <vector>
+#include <iostream>
+#include <type_traits>
+
+#include "_storage.h"
+#include "_edge_table.h"
+
+
+/* Statistics of a group of containers */
+struct ContainerStats {
+    ContainerStats () : count(0), size(0), hashed(0), buckets(0), bytes(0), max_load_factor(0) {}
+
+    inline double load_factor() const {
+        return buckets ? (double)hashed / buckets : 0;
+    }
+
+    inline ContainerStats &operator+=(const ContainerStats &other) {
+        count += other.count;
+        size += other.size;
+        hashed += other.hashed;
+        buckets += other.buckets;
+        bytes += other.bytes;
+        if (other.max_load_factor > max_load_factor)
+            max_load_factor = other.max_load_factor;
+        return *this;
+    }
+
+    /* Take out other, added before. The largest load factor is kept,
+     * since it cannot be undone. */
+    inline ContainerStats &operator-=(const ContainerStats &other) {
+        count -= other.count;
+        size -= other.size;
+        hashed -= other.hashed;
+        buckets -= other.buckets;
+        bytes -= other.bytes;
+        return *this;
+    }
+
+    std::size_t count;          /* containers */
+    std::size_t size;           /* items */
+    std::size_t hashed;         /* items kept in hash tables */
+    std::size_t buckets;        /* hash buckets */
+    std::size_t bytes;          /* estimated bytes */
+    double max_load_factor;     /* largest load factor of a single hash table */
+};
+
+inline std::ostream& operator<<(std::ostream& out, const ContainerStats& s) {
+    out << "{#(container)=" << s.count << ", #(item)=" << s.size
+        << ", #(bucket)=" << s.buckets << ", load=" << s.load_factor()
+        << ", max_load=" << s.max_load_factor << ", bytes=" << s.bytes << "}";
+    return out;
+}
+
+/* Statistics of a network */
+struct NetworkStats {
+    NetworkStats () : nodes(), adjacency(), neighbors(), edges(), other_bytes(0), rehashes(0) {}
+
+    inline std::size_t total_bytes() const {
+        return nodes.bytes + adjacency.bytes + neighbors.bytes + edges.bytes + other_bytes;
+    }
+
+    ContainerStats nodes;       /* node data */
+    ContainerStats adjacency;   /* node -> neighbors */
+    ContainerStats neighbors;   /* neighbor -> edge index, of all nodes */
+    ContainerStats edges;       /* edge table */
+    std::size_t other_bytes;    /* indices kept besides the above */
+    std::size_t rehashes;       /* rehashes and regrowths since construction */
+};
+
+inline std::ostream& operator<<(std::ostream& out, const NetworkStats& s) {
+    out << "Network stats {total_bytes=" << s.total_bytes()
+        << ", rehashes=" << s.rehashes << ",\n"
+        << "  nodes=" << s.nodes << ",\n"
+        << "  adjacency=" << s.adjacency << ",\n"
+        << "  neighbors=" << s.neighbors << ",\n"
+        << "  edges=" << s.edges << ",\n"
+        << "  other_bytes=" << s.other_bytes << "}";
+    return out;
+}
+
+
+/* Bytes taken by a heap block of n bytes. */
+inline std::size_t _heap_bytes(std::size_t n) {
+    if (n == 0) return 0;
+    std::size_t b = (n + sizeof(std::size_t) + 15) & ~(std::size_t)15;
+    return b < 32 ? 32 : b;
+}
+
+template <class _K, class _V>
+inline ContainerStats _container_stats(const std::unordered_map<_K, _V> &m) {
+    /* Hash codes are cached in the nodes unless the key is a scalar. */
+    const std::size_t node = sizeof(void *) + sizeof(std::pair<const _K, _V>)
+        + (std::is_scalar<_K>::value ? 0 : sizeof(std::size_t));
+    ContainerStats s;
+    s.count = 1;
+    s.size = s.hashed = m.size();
+    s.buckets = m.bucket_count();
+    s.bytes = sizeof(m) + _heap_bytes(s.buckets * sizeof(void *)) + s.size * _heap_bytes(node);
+    s.max_load_factor = m.load_factor();
+    return s;
+}
+
+template <class _K, class _V>
+inline ContainerStats _container_stats(const DenseMap<_K, _V> &m) {
+    ContainerStats s;
+    s.count = 1;
+    s.size = m.size();
+    s.bytes = sizeof(m) + _heap_bytes(m.capacity() * (sizeof(std::pair<_K, _V>) + sizeof(char)));
+    return s;
+}
+
+template <class _K, class _V>
+inline ContainerStats _container_stats(const IndexedMap<_K, _V> &m) {
+    ContainerStats s;
+    if (m.indexed()) {
+        s = _container_stats(m.index());
+        s.bytes -= sizeof(m.index());
+    }
+    s.count = 1;
+    s.size = m.size();
+    s.bytes += sizeof(m) + _heap_bytes(m.capacity() * sizeof(std::pair<_K, _V>));
+    return s;
+}
+
+template <class _K, class _V>
+inline ContainerStats _container_stats(const SortedMap<_K, _V> &m) {
+    ContainerStats s;
+    s.count = 1;
+    s.size = m.size();
+    s.bytes = sizeof(m) + _heap_bytes(m.capacity() * sizeof(std::pair<_K, _V>));
+    return s;
+}
+
+template <class _NId, class _EData>
+inline ContainerStats _container_stats(const EdgeTable<_NId, _EData> &t) {
+    ContainerStats s;
+    s.count = 1;
+    s.size = t.size();
+    s.bytes = sizeof(t) + t.capacity() * sizeof(EdgeRecord<_NId, _EData>);
+    return s;
+}
+
+/* Statistics of a map of maps, including the inner maps. */
+template <class _Map>
+inline void _nested_stats(const _Map &m, ContainerStats &outer, ContainerStats &inner) {
+    outer += _container_stats(m);
+    for (auto &i : m)
+        inner += _container_stats(i.second);
+    /* Inner maps are stored inside the items of the outer one. */
+    inner.bytes -= m.size() * sizeof(typename _Map::mapped_type);
+}
+
+
+/* A value that changes whenever the container rehashes or regrows. */
+template <class _K, class _V>
+inline std::size_t _growth_mark(const std::unordered_map<_K, _V> &m) {
+    return m.bucket_count();
+}
+
+template <class _K, class _V>
+inline std::size_t _growth_mark(const DenseMap<_K, _V> &m) {
+    return m.capacity();
+}
+
+template <class _K, class _V>
+inline std::size_t _growth_mark(const IndexedMap<_K, _V> &m) {
+    return m.capacity() + m.index().bucket_count();
+}
+
+template <class _K, class _V>
+inline std::size_t _growth_mark(const SortedMap<_K, _V> &m) {
+    return m.capacity();
+}
+
+#endif /* ifndef CIMNET_STATS */
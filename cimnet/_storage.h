@@ -0,0 +1,527 @@
+/*
+ * This file contains code from https://github.com/hxt-tg/cimnet
+ * and is covered under the copyright and warranty notices:
+ * "Copyright (C) 2022 CimNet Developers
+ *  Xintao Hu <hxt.taoge@gmail.com>"
+ */
+
+/*
+ *  This file contains storage policies of networks, which select the
+ *  containers keyed by node ids. Node data and adjacency are kept in
+ *  NodeMap, and neighbors of each node in NeighborMap.
+ *  For further usage, check out http://doc.hxtcloud.cn.
+ *
+ *
+ *  HashStorage (default)
+ *
+ *  Nodes are kept in std::unordered_map. Any hashable type could be
+ *  used as node id. Neighbors are kept in IndexedMap, which supports
+ *  picking the i-th neighbor in O(1).
+ *
+ *
+ *  DenseStorage
+ *
+ *  Nodes are kept in DenseMap, a vector indexed directly by node id.
+ *  Node ids should be nonnegative integers, and memory is proportional
+ *  to the largest id, so it suits networks labelled 0 to n-1 (such as
+ *  all networks in network.h). Looking up a node involves no hashing.
+ *  Neighbors are kept in IndexedMap as in HashStorage.
+ *
+ *
+ *  SortedStorage<_Storage>
+ *
+ *  Nodes are kept as in _Storage (HashStorage by default), and the
+ *  neighbors of each node in SortedMap, sorted by id. Node ids should
+ *  be ordered by operator<. Neighbors of two nodes could then be
+ *  intersected by merging (see Network::common_neighbors), while adding
+ *  or removing an edge takes O(degree).
+ */
+
+#ifndef CIMNET_STORAGE
+#define CIMNET_STORAGE
+
+#include <unordered_map>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+#include <algorithm>
+
+
+/* Iterator over occupied slots of a DenseMap */
+template <class _Pair>
+class DenseMapIterator {
+public:
+    DenseMapIterator(_Pair *slots, const char *used, std::size_t pos, std::size_t end)
+            : _slots{slots}, _used{used}, _pos{pos}, _end{end} {
+        _skip();
+    }
+
+    bool operator==(const DenseMapIterator &other) const {
+        return _pos == other._pos;
+    }
+
+    bool operator!=(const DenseMapIterator &other) const {
+        return _pos != other._pos;
+    }
+
+    _Pair &operator*() const {
+        return _slots[_pos];
+    }
+
+    _Pair *operator->() const {
+        return _slots + _pos;
+    }
+
+    DenseMapIterator &operator++() {
+        ++_pos;
+        _skip();
+        return *this;
+    }
+
+    std::size_t position() const {
+        return _pos;
+    }
+
+private:
+    void _skip() {
+        while (_pos < _end && !_used[_pos]) ++_pos;
+    }
+
+    _Pair *_slots{};
+    const char *_used{};
+    std::size_t _pos{};
+    std::size_t _end{};
+};
+
+
+/* Map from nonnegative integer keys to values, stored in a vector
+ * indexed by key. Follows the subset of std::unordered_map used by
+ * networks. */
+template <class _K, class _V>
+class DenseMap {
+    static_assert(std::is_integral<_K>::value, "DenseMap requires integer keys.");
+
+    public:
+    typedef _K key_type;
+    typedef _V mapped_type;
+    typedef std::pair<_K, _V> value_type;
+    typedef DenseMapIterator<value_type> iterator;
+    typedef DenseMapIterator<const value_type> const_iterator;
+
+    DenseMap () : _slots(), _used(), _size(0) {}
+
+    inline iterator begin() {
+        return iterator(_slots.data(), _used.data(), 0, _slots.size());
+    }
+
+    inline iterator end() {
+        return iterator(_slots.data(), _used.data(), _slots.size(), _slots.size());
+    }
+
+    inline const_iterator begin() const {
+        return const_iterator(_slots.data(), _used.data(), 0, _slots.size());
+    }
+
+    inline const_iterator end() const {
+        return const_iterator(_slots.data(), _used.data(), _slots.size(), _slots.size());
+    }
+
+    inline iterator find(const _K &key) {
+        if (!_contains(key)) return end();
+        return iterator(_slots.data(), _used.data(), key, _slots.size());
+    }
+
+    inline const_iterator find(const _K &key) const {
+        if (!_contains(key)) return end();
+        return const_iterator(_slots.data(), _used.data(), key, _slots.size());
+    }
+
+    inline std::size_t count(const _K &key) const {
+        return _contains(key) ? 1 : 0;
+    }
+
+    inline _V &at(const _K &key) {
+        if (!_contains(key)) throw std::out_of_range("DenseMap::at");
+        return _slots[key].second;
+    }
+
+    inline const _V &at(const _K &key) const {
+        if (!_contains(key)) throw std::out_of_range("DenseMap::at");
+        return _slots[key].second;
+    }
+
+    inline _V &operator[](const _K &key) {
+        if (_negative(key, std::is_signed<_K>())) throw std::out_of_range("DenseMap: negative key");
+        std::size_t k = key;
+        if (k >= _slots.size()) {
+            _slots.resize(k + 1);
+            _used.resize(k + 1, 0);
+        }
+        if (!_used[k]) {
+            _slots[k].first = key;
+            _used[k] = 1;
+            ++_size;
+        }
+        return _slots[k].second;
+    }
+
+    inline void erase(iterator it) {
+        _release(it.position());
+    }
+
+    inline std::size_t erase(const _K &key) {
+        if (!_contains(key)) return 0;
+        _release(key);
+        return 1;
+    }
+
+    inline void reserve(std::size_t n) {
+        _slots.reserve(n);
+        _used.reserve(n);
+    }
+
+    inline void clear() {
+        _slots.clear();
+        _used.clear();
+        _size = 0;
+    }
+
+    inline std::size_t size() const {
+        return _size;
+    }
+
+    inline bool empty() const {
+        return _size == 0;
+    }
+
+    inline std::size_t capacity() const {
+        return _slots.capacity();
+    }
+
+    private:
+    inline bool _contains(const _K &key) const {
+        return !_negative(key, std::is_signed<_K>()) && (std::size_t)key < _slots.size() && _used[key];
+    }
+
+    static inline bool _negative(const _K &key, std::true_type) {
+        return key < 0;
+    }
+
+    static inline bool _negative(const _K &, std::false_type) {
+        return false;
+    }
+
+    inline void _release(std::size_t k) {
+        _slots[k].second = _V();
+        _used[k] = 0;
+        --_size;
+    }
+
+    std::vector<value_type> _slots;
+    std::vector<char> _used;
+    std::size_t _size;
+};
+
+
+/* Map whose items are kept contiguously in insertion order, so the
+ * i-th item is reachable in O(1) (see nth). Erasing moves the last item
+ * into the freed position. Lookups scan the items while the map is
+ * small, and go through a hash index from key to position once it
+ * grows beyond INDEX_THRESHOLD items. */
+template <class _K, class _V>
+class IndexedMap {
+    static const std::size_t INDEX_THRESHOLD = 16;
+
+    public:
+    typedef _K key_type;
+    typedef _V mapped_type;
+    typedef std::pair<_K, _V> value_type;
+    typedef typename std::vector<value_type>::iterator iterator;
+    typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+    IndexedMap () : _items(), _index() {}
+
+    inline iterator begin() {
+        return _items.begin();
+    }
+
+    inline iterator end() {
+        return _items.end();
+    }
+
+    inline const_iterator begin() const {
+        return _items.begin();
+    }
+
+    inline const_iterator end() const {
+        return _items.end();
+    }
+
+    inline iterator find(const _K &key) {
+        return _items.begin() + _position(key);
+    }
+
+    inline const_iterator find(const _K &key) const {
+        return _items.begin() + _position(key);
+    }
+
+    inline std::size_t count(const _K &key) const {
+        return _position(key) != _items.size() ? 1 : 0;
+    }
+
+    inline _V &at(const _K &key) {
+        std::size_t pos = _position(key);
+        if (pos == _items.size()) throw std::out_of_range("IndexedMap::at");
+        return _items[pos].second;
+    }
+
+    inline const _V &at(const _K &key) const {
+        std::size_t pos = _position(key);
+        if (pos == _items.size()) throw std::out_of_range("IndexedMap::at");
+        return _items[pos].second;
+    }
+
+    inline _V &operator[](const _K &key) {
+        return emplace(key, _V()).first->second;
+    }
+
+    inline std::pair<iterator, bool> emplace(const _K &key, const _V &value) {
+        if (!_index.empty()) {
+            /* Look up and insert with a single probe of the index. */
+            auto r = _index.emplace(key, _items.size());
+            if (!r.second)
+                return std::make_pair(_items.begin() + r.first->second, false);
+            _items.emplace_back(key, value);
+            return std::make_pair(_items.end() - 1, true);
+        }
+        std::size_t pos = _position(key);
+        if (pos != _items.size())
+            return std::make_pair(_items.begin() + pos, false);
+        _items.emplace_back(key, value);
+        if (_items.size() > INDEX_THRESHOLD)
+            _build_index();
+        return std::make_pair(_items.begin() + pos, true);
+    }
+
+    inline std::size_t erase(const _K &key) {
+        std::size_t pos = _position(key);
+        if (pos == _items.size()) return 0;
+        std::size_t last = _items.size() - 1;
+        if (pos != last) {
+            _items[pos] = std::move(_items[last]);
+            if (!_index.empty()) _index[_items[pos].first] = (unsigned)pos;
+        }
+        _items.pop_back();
+        if (!_index.empty()) {
+            _index.erase(key);
+            if (_items.size() <= INDEX_THRESHOLD / 2)
+                std::unordered_map<_K, unsigned>().swap(_index);
+        }
+        return 1;
+    }
+
+    /* The i-th item, 0 <= i < size(). */
+    inline value_type &nth(std::size_t i) {
+        return _items[i];
+    }
+
+    inline const value_type &nth(std::size_t i) const {
+        return _items[i];
+    }
+
+    inline void reserve(std::size_t n) {
+        _items.reserve(n);
+        if (!_index.empty()) _index.reserve(n);
+    }
+
+    inline void clear() {
+        _items.clear();
+        _index.clear();
+    }
+
+    inline std::size_t size() const {
+        return _items.size();
+    }
+
+    inline bool empty() const {
+        return _items.empty();
+    }
+
+    inline std::size_t capacity() const {
+        return _items.capacity();
+    }
+
+    /* Whether lookups go through the hash index. */
+    inline bool indexed() const {
+        return !_index.empty();
+    }
+
+    inline const std::unordered_map<_K, unsigned> &index() const {
+        return _index;
+    }
+
+    private:
+    /* Position of key, or size() if absent. */
+    inline std::size_t _position(const _K &key) const {
+        if (_index.empty()) {
+            std::size_t pos = 0;
+            while (pos < _items.size() && !(_items[pos].first == key)) ++pos;
+            return pos;
+        }
+        auto it = _index.find(key);
+        return it == _index.end() ? _items.size() : it->second;
+    }
+
+    /* The index is sized by the capacity of items, which follows any
+     * reserve() hint. */
+    inline void _build_index() {
+        _index.reserve(_items.capacity());
+        for (std::size_t i = 0; i < _items.size(); i++)
+            _index[_items[i].first] = (unsigned)i;
+    }
+
+    std::vector<value_type> _items;
+    std::unordered_map<_K, unsigned> _index;
+};
+
+
+/* Map whose items are kept contiguously and sorted by key, so the i-th
+ * item is reachable in O(1) (see nth) and two maps could be intersected
+ * by merging. Lookups are binary searches. Inserting or erasing shifts
+ * the items after it. */
+template <class _K, class _V>
+class SortedMap {
+    public:
+    typedef _K key_type;
+    typedef _V mapped_type;
+    typedef std::pair<_K, _V> value_type;
+    typedef typename std::vector<value_type>::iterator iterator;
+    typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+    SortedMap () : _items() {}
+
+    inline iterator begin() {
+        return _items.begin();
+    }
+
+    inline iterator end() {
+        return _items.end();
+    }
+
+    inline const_iterator begin() const {
+        return _items.begin();
+    }
+
+    inline const_iterator end() const {
+        return _items.end();
+    }
+
+    inline iterator find(const _K &key) {
+        iterator it = _lower_bound(_items.begin(), _items.end(), key);
+        return it != _items.end() && !(key < it->first) ? it : _items.end();
+    }
+
+    inline const_iterator find(const _K &key) const {
+        const_iterator it = _lower_bound(_items.begin(), _items.end(), key);
+        return it != _items.end() && !(key < it->first) ? it : _items.end();
+    }
+
+    inline std::size_t count(const _K &key) const {
+        return find(key) != end() ? 1 : 0;
+    }
+
+    inline _V &at(const _K &key) {
+        iterator it = find(key);
+        if (it == end()) throw std::out_of_range("SortedMap::at");
+        return it->second;
+    }
+
+    inline const _V &at(const _K &key) const {
+        const_iterator it = find(key);
+        if (it == end()) throw std::out_of_range("SortedMap::at");
+        return it->second;
+    }
+
+    inline _V &operator[](const _K &key) {
+        return emplace(key, _V()).first->second;
+    }
+
+    inline std::pair<iterator, bool> emplace(const _K &key, const _V &value) {
+        iterator it = _lower_bound(_items.begin(), _items.end(), key);
+        if (it != _items.end() && !(key < it->first))
+            return std::make_pair(it, false);
+        return std::make_pair(_items.insert(it, value_type(key, value)), true);
+    }
+
+    inline std::size_t erase(const _K &key) {
+        iterator it = find(key);
+        if (it == end()) return 0;
+        _items.erase(it);
+        return 1;
+    }
+
+    /* The i-th smallest item, 0 <= i < size(). */
+    inline value_type &nth(std::size_t i) {
+        return _items[i];
+    }
+
+    inline const value_type &nth(std::size_t i) const {
+        return _items[i];
+    }
+
+    inline void reserve(std::size_t n) {
+        _items.reserve(n);
+    }
+
+    inline void clear() {
+        _items.clear();
+    }
+
+    inline std::size_t size() const {
+        return _items.size();
+    }
+
+    inline bool empty() const {
+        return _items.empty();
+    }
+
+    inline std::size_t capacity() const {
+        return _items.capacity();
+    }
+
+    private:
+    template <class _Iter>
+    static inline _Iter _lower_bound(_Iter begin, _Iter end, const _K &key) {
+        return std::lower_bound(begin, end, key,
+                [](const value_type &item, const _K &k) { return item.first < k; });
+    }
+
+    std::vector<value_type> _items;
+};
+
+
+/* Storage policies */
+struct HashStorage {
+    template <class _K, class _V>
+    using NodeMap = std::unordered_map<_K, _V>;
+    template <class _K, class _V>
+    using NeighborMap = IndexedMap<_K, _V>;
+};
+
+struct DenseStorage {
+    template <class _K, class _V>
+    using NodeMap = DenseMap<_K, _V>;
+    template <class _K, class _V>
+    using NeighborMap = IndexedMap<_K, _V>;
+};
+
+template <class _Storage=HashStorage>
+struct SortedStorage {
+    template <class _K, class _V>
+    using NodeMap = typename _Storage::template NodeMap<_K, _V>;
+    template <class _K, class _V>
+    using NeighborMap = SortedMap<_K, _V>;
+};
+
+#endif /* ifndef CIMNET_STORAGE */
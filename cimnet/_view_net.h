@@ -0,0 +1,868 @@
+/*
+ * This file contains code from https://github.com/hxt-tg/cimnet
+ * and is covered under the copyright and warranty notices:
+ * "Copyright (C) 2022 CimNet Developers
+ *  Xintao Hu <hxt.taoge@gmail.com>"
+ */
+
+/*
+ *  This file contains read-only views of networks. A view keeps a
+ *  pointer to its network and answers queries from the network's own
+ *  nodes, neighbor maps and edge table, so nothing is copied. It
+ *  reflects later changes of the network, and must not outlive it.
+ *
+ *  A filtered view shows the nodes accepted by a node predicate, and
+ *  the edges between them accepted by an edge predicate:
+ *
+ *      bool node_pred(const _NId &id);
+ *      bool edge_pred(const _NId &id1, const _NId &id2, const _EData &data);
+ *
+ *  Counting nodes, edges and degrees walks the view, as the predicates
+ *  are evaluated lazily. A subgraph view is a filtered view on a node
+ *  set, and walks the set rather than all nodes of the network.
+ *
+ *  The reverse view of a directed network swaps successors and
+ *  predecessors, and its undirected view joins both into neighbors.
+ *  They answer the queries of DirectedNetwork and Network respectively,
+ *  so they can be used in place of the converted networks.
+ *  For further usage, check out http://doc.hxtcloud.cn.
+ */
+
+#ifndef CIMNET_VIEW_NET
+#define CIMNET_VIEW_NET
+
+#include <memory>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "_types.h"
+#include "_exception.h"
+#include "_edge_table.h"
+
+
+template <class _NId, class _NData, class _EData, class _Storage>
+class Network;
+template <class _NId, class _NData, class _EData, class _Storage>
+class DirectedNetwork;
+template<class _NId, class _NData, class _EData, class _Storage>
+class NodesView;
+template<class _NId, class _NData, class _EData, class _Storage>
+class NeighborView;
+template<class _NId, class _NData, class _EData, class _Storage>
+class DiNeighborView;
+
+
+/* Predicates accepting every node or edge */
+struct AllNodes {
+    template <class _NId>
+    bool operator()(const _NId &) const {
+        return true;
+    }
+};
+
+struct AllEdges {
+    template <class _NId, class _EData>
+    bool operator()(const _NId &, const _NId &, const _EData &) const {
+        return true;
+    }
+};
+
+/* Predicate accepting the nodes of a set. Copies of the predicate (and
+ * of views using it) share the set. */
+template <class _NId>
+class InNodeSet {
+public:
+    explicit InNodeSet(std::unordered_set<_NId> nodes)
+            : _nodes(std::make_shared<const std::unordered_set<_NId>>(std::move(nodes))) {}
+
+    bool operator()(const _NId &id) const {
+        return _nodes->count(id) != 0;
+    }
+
+    const std::unordered_set<_NId> &nodes() const {
+        return *_nodes;
+    }
+
+private:
+    std::shared_ptr<const std::unordered_set<_NId>> _nodes;
+};
+
+
+/* Iterator over the items x of [iter, end) for which keep(x) holds,
+ * yielding get(x). */
+template <class _Iter, class _Keep, class _Get>
+class FilterIterator {
+public:
+    FilterIterator(const _Iter &iter, const _Iter &end, const _Keep &keep, const _Get &get)
+            : _iter{iter}, _end{end}, _keep(keep), _get(get) {
+        _skip();
+    }
+
+    bool operator!=(const FilterIterator &other) const {
+        return _iter != other._iter;
+    }
+
+    auto operator*() const -> decltype(std::declval<const _Get &>()(*std::declval<const _Iter &>())) {
+        return _get(*_iter);
+    }
+
+    const FilterIterator &operator++() {
+        ++_iter;
+        _skip();
+        return *this;
+    }
+
+private:
+    void _skip() {
+        while (_iter != _end && !_keep(*_iter)) ++_iter;
+    }
+
+    _Iter _iter{};
+    _Iter _end{};
+    _Keep _keep;
+    _Get _get;
+};
+
+template <class _Iter, class _Keep, class _Get>
+class FilterRange {
+public:
+    using _FilterIterator = FilterIterator<_Iter, _Keep, _Get>;
+
+    FilterRange(const _Iter &begin, const _Iter &end, const _Keep &keep, const _Get &get)
+            : _begin(begin), _end(end), _keep(keep), _get(get) {}
+
+    _FilterIterator begin() const {
+        return _FilterIterator(_begin, _end, _keep, _get);
+    }
+
+    _FilterIterator end() const {
+        return _FilterIterator(_end, _end, _keep, _get);
+    }
+
+private:
+    _Iter _begin{};
+    _Iter _end{};
+    _Keep _keep;
+    _Get _get;
+};
+
+template <class _Range>
+inline int _range_size(const _Range &range) {
+    int n = 0;
+    for (auto it = range.begin(), end = range.end(); it != end; ++it)
+        n++;
+    return n;
+}
+
+/* Counting iterator over edge indices */
+class _IndexIterator {
+public:
+    explicit _IndexIterator(int index) : _index{index} {}
+
+    bool operator!=(const _IndexIterator &other) const {
+        return _index != other._index;
+    }
+
+    int operator*() const {
+        return _index;
+    }
+
+    _IndexIterator &operator++() {
+        ++_index;
+        return *this;
+    }
+
+private:
+    int _index{};
+};
+
+
+/* Parts of filter iterators */
+struct _FirstOf {
+    template <class _Pair>
+    auto operator()(const _Pair &p) const -> decltype((p.first)) {
+        return p.first;
+    }
+};
+
+struct _Always {
+    template <class _T>
+    bool operator()(const _T &) const {
+        return true;
+    }
+};
+
+struct _Itself {
+    template <class _T>
+    const _T &operator()(const _T &x) const {
+        return x;
+    }
+};
+
+/* Accepts edge e (or neighbor map entry (id, e)) if both ends pass the
+ * node predicate and the edge passes the edge predicate. */
+template <class _NId, class _EData, class _NodePred, class _EdgePred>
+struct _EdgeFilter {
+    bool operator()(int e) const {
+        const auto &rec = edges->record(e);
+        return node_pred(rec.first) && node_pred(rec.second)
+            && edge_pred(rec.first, rec.second, rec.payload());
+    }
+
+    bool operator()(const std::pair<_NId, int> &entry) const {
+        return (*this)(entry.second);
+    }
+
+    const EdgeTable<_NId, _EData> *edges;
+    _NodePred node_pred;
+    _EdgePred edge_pred;
+};
+
+template <class _NId, class _EData, bool _Directed>
+struct _EdgeEnds {
+    std::pair<_NId, _NId> operator()(int e) const {
+        const auto &rec = edges->record(e);
+        if (!_Directed && rec.second < rec.first)
+            return std::make_pair(rec.second, rec.first);
+        return std::make_pair(rec.first, rec.second);
+    }
+
+    const EdgeTable<_NId, _EData> *edges;
+};
+
+template <class _NId, class _EData>
+struct _ReversedEnds {
+    std::pair<_NId, _NId> operator()(int e) const {
+        const auto &rec = edges->record(e);
+        return std::make_pair(rec.second, rec.first);
+    }
+
+    const EdgeTable<_NId, _EData> *edges;
+};
+
+/* Accepts a directed edge unless its reverse edge comes earlier in the
+ * edge table, so that each pair of mutual edges is taken once. The
+ * reverse is read from the reciprocal index if given. */
+template <class _NId, class _EData, class _AdjType>
+struct _FirstOfMutual {
+    bool operator()(int e) const {
+        int r;
+        if (reverse) {
+            r = (*reverse)[e];
+        } else {
+            const auto &rec = edges->record(e);
+            const auto &back = succ->find(rec.second)->second;
+            auto it = back.find(rec.first);
+            r = it == back.end() ? -1 : it->second;
+        }
+        return r < 0 || r >= e;
+    }
+
+    const EdgeTable<_NId, _EData> *edges;
+    const _AdjType *succ;
+    const std::vector<int> *reverse;
+};
+
+/* Nodes walked by a view: all nodes of the network that pass the node
+ * predicate, or for a subgraph, the nodes of its set in the network. */
+template <class _NType, class _NodePred>
+struct _NodeSource {
+    struct _Keep {
+        template <class _Pair>
+        bool operator()(const _Pair &p) const {
+            return pred(p.first);
+        }
+
+        _NodePred pred;
+    };
+
+    typedef FilterRange<typename _NType::const_iterator, _Keep, _FirstOf> _Range;
+
+    static _Range range(const _NType &nodes, const _NodePred &pred) {
+        return _Range(nodes.begin(), nodes.end(), _Keep{pred}, _FirstOf());
+    }
+};
+
+template <class _NType, class _NId>
+struct _NodeSource<_NType, InNodeSet<_NId>> {
+    struct _Keep {
+        bool operator()(const _NId &id) const {
+            return nodes->find(id) != nodes->end();
+        }
+
+        const _NType *nodes;
+    };
+
+    typedef FilterRange<typename std::unordered_set<_NId>::const_iterator, _Keep, _Itself> _Range;
+
+    static _Range range(const _NType &nodes, const InNodeSet<_NId> &pred) {
+        return _Range(pred.nodes().begin(), pred.nodes().end(), _Keep{&nodes}, _Itself());
+    }
+};
+
+
+/* Read-only view of a network through a node and an edge predicate,
+ * specialized for Network and DirectedNetwork below. */
+template <class _Net, class _NodePred=AllNodes, class _EdgePred=AllEdges>
+class FilteredView;
+
+/* Filtered view of an undirected network */
+template <class _NId, class _NData, class _EData, class _Storage, class _NodePred, class _EdgePred>
+class FilteredView<Network<_NId, _NData, _EData, _Storage>, _NodePred, _EdgePred> {
+    typedef Network<_NId, _NData, _EData, _Storage> _NetType;
+    typedef typename _Storage::template NodeMap<_NId, _NData> _NType;
+    typedef typename _Storage::template NeighborMap<_NId, int> _NeiType;
+    typedef _EdgeFilter<_NId, _EData, _NodePred, _EdgePred> _EFilterType;
+
+    friend std::ostream& operator<<(std::ostream& out, const FilteredView& view) {
+        out << "Filtered view {#(node)=" << view.number_of_nodes()
+            << ", #(edge)=" << view.number_of_edges()
+            << ", #(degree)=" << view.total_degree() << "}";
+        return out;
+    }
+
+    public:
+    typedef typename _NodeSource<_NType, _NodePred>::_Range NodeRange;
+    typedef FilterRange<typename _NeiType::const_iterator, _EFilterType, _FirstOf> NeighborRange;
+    typedef FilterRange<_IndexIterator, _EFilterType, _EdgeEnds<_NId, _EData, false>> EdgeRange;
+
+    FilteredView (const _NetType &net, const _NodePred &node_pred=_NodePred(),
+            const _EdgePred &edge_pred=_EdgePred())
+        : _net(&net), _node_pred(node_pred), _edge_pred(edge_pred) {}
+
+    inline const _NetType &network() const {
+        return *_net;
+    }
+
+    inline bool has_node(const _NId &id) const {
+        return _net->has_node(id) && _node_pred(id);
+    }
+
+    inline bool has_edge(const _NId &id1, const _NId &id2) const {
+        int e = _find_edge(id1, id2);
+        return e >= 0 && _edge_filter()(e);
+    }
+
+    inline bool is_neighbor(const _NId &id1, const _NId &id2) const {
+        return has_edge(id1, id2);
+    }
+
+    inline const _NData &get_node_data(const _NId &id) const {
+        if (!_node_pred(id)) throw NoNodeException<_NId>(id);
+        auto it = _net->_nodes.find(id);
+        if (it == _net->_nodes.end()) throw NoNodeException<_NId>(id);
+        return it->second;
+    }
+
+    inline const _EData &get_edge_data(const _NId &id1, const _NId &id2) const {
+        if (!has_node(id1)) throw NoNodeException<_NId>(id1);
+        if (!has_node(id2)) throw NoNodeException<_NId>(id2);
+        int e = _find_edge(id1, id2);
+        if (e < 0 || !_edge_filter()(e)) throw NoEdgeException<_NId>(id1, id2);
+        return _net->_edges.data(e);
+    }
+
+    /* O(n) for filtered views, O(|set|) for subgraph views. */
+    inline int number_of_nodes() const {
+        return _range_size(iterate_nodes());
+    }
+
+    /* O(m) */
+    inline int number_of_edges() const {
+        return _range_size(iterate_edges());
+    }
+
+    inline int total_degree() const {
+        int degree = 0;
+        for (auto &n : iterate_nodes())
+            degree += this->degree(n);
+        return degree;
+    }
+
+    inline int degree(const _NId &id) const {
+        if (!has_node(id)) return 0;
+        return _range_size(iterate_neighbors(id));
+    }
+
+    inline std::vector<_NId> neighbors(const _NId &id) const {
+        std::vector<_NId> nei;
+        if (has_node(id))
+            for (auto &n : iterate_neighbors(id))
+                nei.push_back(n);
+        return nei;
+    }
+
+    inline NeighborRange iterate_neighbors(const _NId &id) const {
+        if (!has_node(id)) throw NoNodeException<_NId>(id);
+        const _NeiType &nei = _net->_adjs.find(id)->second;
+        return NeighborRange(nei.begin(), nei.end(), _edge_filter(), _FirstOf());
+    }
+
+    inline std::vector<_NId> nodes() const {
+        std::vector<_NId> nodes;
+        for (auto &n : iterate_nodes())
+            nodes.push_back(n);
+        return nodes;
+    }
+
+    inline NodeRange iterate_nodes() const {
+        return _NodeSource<_NType, _NodePred>::range(_net->_nodes, _node_pred);
+    }
+
+    inline EdgeRange iterate_edges() const {
+        return EdgeRange(_IndexIterator(0), _IndexIterator(_net->_edges.size()), _edge_filter(),
+                _EdgeEnds<_NId, _EData, false>{&_net->_edges});
+    }
+
+    private:
+    inline _EFilterType _edge_filter() const {
+        return _EFilterType{&_net->_edges, _node_pred, _edge_pred};
+    }
+
+    /* Index of edge (id1, id2) in the network, or -1. */
+    inline int _find_edge(const _NId &id1, const _NId &id2) const {
+        auto it = _net->_adjs.find(id1);
+        if (it == _net->_adjs.end()) return -1;
+        auto e = it->second.find(id2);
+        return e == it->second.end() ? -1 : e->second;
+    }
+
+    const _NetType *_net;
+    _NodePred _node_pred;
+    _EdgePred _edge_pred;
+};
+
+/* Filtered view of a directed network */
+template <class _NId, class _NData, class _EData, class _Storage, class _NodePred, class _EdgePred>
+class FilteredView<DirectedNetwork<_NId, _NData, _EData, _Storage>, _NodePred, _EdgePred> {
+    typedef DirectedNetwork<_NId, _NData, _EData, _Storage> _DiNetType;
+    typedef typename _Storage::template NodeMap<_NId, _NData> _NType;
+    typedef typename _Storage::template NeighborMap<_NId, int> _NeiType;
+    typedef _EdgeFilter<_NId, _EData, _NodePred, _EdgePred> _EFilterType;
+
+    friend std::ostream& operator<<(std::ostream& out, const FilteredView& view) {
+        out << "Filtered directed view {#(node)=" << view.number_of_nodes()
+            << ", #(edge)=" << view.number_of_edges()
+            << ", #(degree)=" << view.total_degree() << "}";
+        return out;
+    }
+
+    public:
+    typedef typename _NodeSource<_NType, _NodePred>::_Range NodeRange;
+    typedef FilterRange<typename _NeiType::const_iterator, _EFilterType, _FirstOf> NeighborRange;
+    typedef FilterRange<_IndexIterator, _EFilterType, _EdgeEnds<_NId, _EData, true>> EdgeRange;
+
+    FilteredView (const _DiNetType &net, const _NodePred &node_pred=_NodePred(),
+            const _EdgePred &edge_pred=_EdgePred())
+        : _net(&net), _node_pred(node_pred), _edge_pred(edge_pred) {}
+
+    inline const _DiNetType &network() const {
+        return *_net;
+    }
+
+    inline bool has_node(const _NId &id) const {
+        return _net->has_node(id) && _node_pred(id);
+    }
+
+    inline bool has_successor(const _NId &id1, const _NId &id2) const {
+        int e = _find_edge(_net->_succ, id1, id2);
+        return e >= 0 && _edge_filter()(e);
+    }
+
+    inline bool has_predecessor(const _NId &id1, const _NId &id2) const {
+        int e = _find_edge(_net->_pred, id1, id2);
+        return e >= 0 && _edge_filter()(e);
+    }
+
+    inline bool has_edge(const _NId &id1, const _NId &id2) const {
+        return has_successor(id1, id2);
+    }
+
+    inline bool is_neighbor(const _NId &id1, const _NId &id2) const {
+        return has_successor(id1, id2) || has_predecessor(id1, id2);
+    }
+
+    inline const _NData &get_node_data(const _NId &id) const {
+        if (!_node_pred(id)) throw NoNodeException<_NId>(id);
+        auto it = _net->_nodes.find(id);
+        if (it == _net->_nodes.end()) throw NoNodeException<_NId>(id);
+        return it->second;
+    }
+
+    inline const _EData &get_edge_data(const _NId &id1, const _NId &id2) const {
+        if (!has_node(id1)) throw NoNodeException<_NId>(id1);
+        if (!has_node(id2)) throw NoNodeException<_NId>(id2);
+        int e = _find_edge(_net->_succ, id1, id2);
+        if (e < 0 || !_edge_filter()(e)) throw NoEdgeException<_NId>(id1, id2, true);
+        return _net->_edges.data(e);
+    }
+
+    /* O(n) for filtered views, O(|set|) for subgraph views. */
+    inline int number_of_nodes() const {
+        return _range_size(iterate_nodes());
+    }
+
+    /* O(m) */
+    inline int number_of_edges() const {
+        return _range_size(iterate_edges());
+    }
+
+    inline int total_degree() const {
+        return number_of_edges() * 2;
+    }
+
+    inline int out_degree(const _NId &id) const {
+        if (!has_node(id)) return 0;
+        return _range_size(iterate_successors(id));
+    }
+
+    inline int in_degree(const _NId &id) const {
+        if (!has_node(id)) return 0;
+        return _range_size(iterate_predecessors(id));
+    }
+
+    inline int degree(const _NId &id) const {
+        return out_degree(id) + in_degree(id);
+    }
+
+    inline std::vector<_NId> successors(const _NId &id) const {
+        std::vector<_NId> nei;
+        if (has_node(id))
+            for (auto &n : iterate_successors(id))
+                nei.push_back(n);
+        return nei;
+    }
+
+    inline NeighborRange iterate_successors(const _NId &id) const {
+        if (!has_node(id)) throw NoNodeException<_NId>(id);
+        const _NeiType &nei = _net->_succ.find(id)->second;
+        return NeighborRange(nei.begin(), nei.end(), _edge_filter(), _FirstOf());
+    }
+
+    inline std::vector<_NId> predecessors(const _NId &id) const {
+        std::vector<_NId> nei;
+        if (has_node(id))
+            for (auto &n : iterate_predecessors(id))
+                nei.push_back(n);
+        return nei;
+    }
+
+    inline NeighborRange iterate_predecessors(const _NId &id) const {
+        if (!has_node(id)) throw NoNodeException<_NId>(id);
+        const _NeiType &nei = _net->_pred.find(id)->second;
+        return NeighborRange(nei.begin(), nei.end(), _edge_filter(), _FirstOf());
+    }
+
+    /* Successors, then predecessors that are not successors. */
+    inline std::vector<_NId> neighbors(const _NId &id) const {
+        std::vector<_NId> nei = successors(id);
+        if (has_node(id))
+            for (auto &n : iterate_predecessors(id))
+                if (!has_successor(id, n)) nei.push_back(n);
+        return nei;
+    }
+
+    inline std::vector<_NId> nodes() const {
+        std::vector<_NId> nodes;
+        for (auto &n : iterate_nodes())
+            nodes.push_back(n);
+        return nodes;
+    }
+
+    inline NodeRange iterate_nodes() const {
+        return _NodeSource<_NType, _NodePred>::range(_net->_nodes, _node_pred);
+    }
+
+    inline EdgeRange iterate_edges() const {
+        return EdgeRange(_IndexIterator(0), _IndexIterator(_net->_edges.size()), _edge_filter(),
+                _EdgeEnds<_NId, _EData, true>{&_net->_edges});
+    }
+
+    private:
+    inline _EFilterType _edge_filter() const {
+        return _EFilterType{&_net->_edges, _node_pred, _edge_pred};
+    }
+
+    template <class _Adj>
+    static inline int _find_edge(const _Adj &adj, const _NId &id1, const _NId &id2) {
+        auto it = adj.find(id1);
+        if (it == adj.end()) return -1;
+        auto e = it->second.find(id2);
+        return e == it->second.end() ? -1 : e->second;
+    }
+
+    const _DiNetType *_net;
+    _NodePred _node_pred;
+    _EdgePred _edge_pred;
+};
+
+
+/* Directed network with every edge reversed */
+template <class _NId, class _NData, class _EData, class _Storage>
+class ReverseView {
+    typedef DirectedNetwork<_NId, _NData, _EData, _Storage> _DiNetType;
+    typedef std::pair<_NId, _NId> _EPairType;
+
+    friend std::ostream& operator<<(std::ostream& out, const ReverseView& view) {
+        out << "Reverse view {#(node)=" << view.number_of_nodes()
+            << ", #(edge)=" << view.number_of_edges()
+            << ", #(degree)=" << view.total_degree() << "}";
+        return out;
+    }
+
+    public:
+    typedef FilterRange<_IndexIterator, _Always, _ReversedEnds<_NId, _EData>> EdgeRange;
+
+    explicit ReverseView (const _DiNetType &net) : _net(&net) {}
+
+    inline const _DiNetType &network() const {
+        return *_net;
+    }
+
+    inline bool has_node(const _NId &id) const {
+        return _net->has_node(id);
+    }
+
+    inline bool has_successor(const _NId &id1, const _NId &id2) const {
+        return _net->has_predecessor(id1, id2);
+    }
+
+    inline bool has_predecessor(const _NId &id1, const _NId &id2) const {
+        return _net->has_successor(id1, id2);
+    }
+
+    inline bool has_edge(const _NId &id1, const _NId &id2) const {
+        return _net->has_successor(id2, id1);
+    }
+
+    inline bool is_neighbor(const _NId &id1, const _NId &id2) const {
+        return _net->is_neighbor(id1, id2);
+    }
+
+    inline const _NData &get_node_data(const _NId &id) const {
+        auto it = _net->_nodes.find(id);
+        if (it == _net->_nodes.end()) throw NoNodeException<_NId>(id);
+        return it->second;
+    }
+
+    inline const _EData &get_edge_data(const _NId &id1, const _NId &id2) const {
+        auto it = _net->_pred.find(id1);
+        if (it == _net->_pred.end()) throw NoNodeException<_NId>(id1);
+        auto e = it->second.find(id2);
+        if (e == it->second.end()) {
+            if (!has_node(id2)) throw NoNodeException<_NId>(id2);
+            throw NoEdgeException<_NId>(id1, id2, true);
+        }
+        return _net->_edges.data(e->second);
+    }
+
+    inline int number_of_nodes() const {
+        return _net->number_of_nodes();
+    }
+
+    inline int number_of_edges() const {
+        return _net->number_of_edges();
+    }
+
+    inline int total_degree() const {
+        return _net->total_degree();
+    }
+
+    inline int out_degree(const _NId &id) const {
+        return _net->in_degree(id);
+    }
+
+    inline int in_degree(const _NId &id) const {
+        return _net->out_degree(id);
+    }
+
+    inline int degree(const _NId &id) const {
+        return _net->degree(id);
+    }
+
+    inline std::vector<_NId> successors(const _NId &id) const {
+        return _net->predecessors(id);
+    }
+
+    inline NeighborView<_NId, _NData, _EData, _Storage> iterate_successors(const _NId &id) const {
+        return _net->iterate_predecessors(id);
+    }
+
+    inline std::vector<_NId> predecessors(const _NId &id) const {
+        return _net->successors(id);
+    }
+
+    inline NeighborView<_NId, _NData, _EData, _Storage> iterate_predecessors(const _NId &id) const {
+        return _net->iterate_successors(id);
+    }
+
+    template <class _Rng=MTEngine>
+    inline _NId random_successor(const _NId &id, _Rng &rng=default_engine()) const {
+        return _net->random_predecessor(id, rng);
+    }
+
+    template <class _Rng=MTEngine>
+    inline _NId random_predecessor(const _NId &id, _Rng &rng=default_engine()) const {
+        return _net->random_successor(id, rng);
+    }
+
+    /* Neighbors are the same in both directions. */
+    inline std::vector<_NId> neighbors(const _NId &id) const {
+        return _net->neighbors(id);
+    }
+
+    inline DiNeighborView<_NId, _NData, _EData, _Storage> iterate_neighbors(const _NId &id) const {
+        return _net->iterate_neighbors(id);
+    }
+
+    template <class _Rng=MTEngine>
+    inline _EPairType random_edge(_Rng &rng=default_engine()) const {
+        _EPairType e = _net->random_edge(rng);
+        return std::make_pair(e.second, e.first);
+    }
+
+    inline std::vector<_NId> nodes() const {
+        return _net->nodes();
+    }
+
+    inline NodesView<_NId, _NData, _EData, _Storage> iterate_nodes() const {
+        return _net->iterate_nodes();
+    }
+
+    inline EdgeRange iterate_edges() const {
+        return EdgeRange(_IndexIterator(0), _IndexIterator(_net->_edges.size()), _Always(),
+                _ReversedEnds<_NId, _EData>{&_net->_edges});
+    }
+
+    inline const _DiNetType &reverse_view() const {
+        return *_net;
+    }
+
+    private:
+    const _DiNetType *_net;
+};
+
+
+/* Directed network seen as undirected: id1 and id2 are linked if
+ * either id1 -> id2 or id2 -> id1 exists. Mutual edges count once and
+ * their data is that of id1 -> id2 when queried as (id1, id2). */
+template <class _NId, class _NData, class _EData, class _Storage>
+class UndirectedView {
+    typedef DirectedNetwork<_NId, _NData, _EData, _Storage> _DiNetType;
+    typedef typename _Storage::template NeighborMap<_NId, int> _NeiType;
+    typedef typename _Storage::template NodeMap<_NId, _NeiType> _AdjType;
+    typedef _FirstOfMutual<_NId, _EData, _AdjType> _MutualType;
+
+    friend std::ostream& operator<<(std::ostream& out, const UndirectedView& view) {
+        out << "Undirected view {#(node)=" << view.number_of_nodes()
+            << ", #(edge)=" << view.number_of_edges()
+            << ", #(degree)=" << view.total_degree() << "}";
+        return out;
+    }
+
+    public:
+    typedef FilterRange<_IndexIterator, _MutualType, _EdgeEnds<_NId, _EData, false>> EdgeRange;
+
+    explicit UndirectedView (const _DiNetType &net) : _net(&net) {}
+
+    inline const _DiNetType &network() const {
+        return *_net;
+    }
+
+    inline bool has_node(const _NId &id) const {
+        return _net->has_node(id);
+    }
+
+    inline bool has_edge(const _NId &id1, const _NId &id2) const {
+        return _net->is_neighbor(id1, id2);
+    }
+
+    inline bool is_neighbor(const _NId &id1, const _NId &id2) const {
+        return _net->is_neighbor(id1, id2);
+    }
+
+    inline const _NData &get_node_data(const _NId &id) const {
+        auto it = _net->_nodes.find(id);
+        if (it == _net->_nodes.end()) throw NoNodeException<_NId>(id);
+        return it->second;
+    }
+
+    inline const _EData &get_edge_data(const _NId &id1, const _NId &id2) const {
+        auto it = _net->_succ.find(id1);
+        if (it == _net->_succ.end()) throw NoNodeException<_NId>(id1);
+        auto e = it->second.find(id2);
+        if (e != it->second.end()) return _net->_edges.data(e->second);
+        const _NeiType &pred = _net->_pred.find(id1)->second;
+        e = pred.find(id2);
+        if (e != pred.end()) return _net->_edges.data(e->second);
+        if (!has_node(id2)) throw NoNodeException<_NId>(id2);
+        throw NoEdgeException<_NId>(id1, id2);
+    }
+
+    inline int number_of_nodes() const {
+        return _net->number_of_nodes();
+    }
+
+    /* O(m) */
+    inline int number_of_edges() const {
+        return _range_size(iterate_edges());
+    }
+
+    /* O(n + m) */
+    inline int total_degree() const {
+        int degree = 0;
+        for (auto &n : _net->iterate_nodes())
+            degree += this->degree(n);
+        return degree;
+    }
+
+    /* Number of distinct neighbors, O(d). */
+    inline int degree(const _NId &id) const {
+        if (!has_node(id)) return 0;
+        return _range_size(iterate_neighbors(id));
+    }
+
+    inline std::vector<_NId> neighbors(const _NId &id) const {
+        return _net->neighbors(id);
+    }
+
+    inline DiNeighborView<_NId, _NData, _EData, _Storage> iterate_neighbors(const _NId &id) const {
+        return _net->iterate_neighbors(id);
+    }
+
+    inline std::vector<_NId> nodes() const {
+        return _net->nodes();
+    }
+
+    inline NodesView<_NId, _NData, _EData, _Storage> iterate_nodes() const {
+        return _net->iterate_nodes();
+    }
+
+    /* Ends of undirected edges in ascending order, as in Network. */
+    inline EdgeRange iterate_edges() const {
+        const std::vector<int> *reverse = _net->_reciprocal ? &_net->_reverse : nullptr;
+        return EdgeRange(_IndexIterator(0), _IndexIterator(_net->_edges.size()),
+                _MutualType{&_net->_edges, &_net->_succ, reverse},
+                _EdgeEnds<_NId, _EData, false>{&_net->_edges});
+    }
+
+    private:
+    const _DiNetType *_net;
+};
+
+
+/* Whether a network or view has directed edges, told by its having
+ * successors. Thus classes derived from directed networks, and directed
+ * interned, shared, frozen and compressed networks, count as well. */
+template <class _Net>
+std::true_type _has_successors(decltype(&_Net::successors));
+
+template <class>
+std::false_type _has_successors(...);
+
+template <class _Net>
+struct _IsDirected : decltype(_has_successors<_Net>(nullptr)) {};
+
+#endif /* ifndef CIMNET_VIEW_NET */
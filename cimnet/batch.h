@@ -0,0 +1,337 @@
+/*
+ * This file contains code from https://github.com/hxt-tg/cimnet
+ * and is covered under the copyright and warranty notices:
+ * "Copyright (C) 2022 CimNet Developers
+ *  Xintao Hu <hxt.taoge@gmail.com>"
+ */
+
+/*
+ *  This file contains batched mutation of networks. A Batch collects
+ *  edge additions, edge removals and data updates, and commit() applies
+ *  them in one pass:
+ *
+ *  1. End nodes of added edges are created, in the order they appear.
+ *  2. Edge changes are grouped by source node (for undirected networks,
+ *     the end with the smaller hash), so that the neighbors of each
+ *     source are looked up once per group rather than once per change.
+ *     Changes of the same edge keep their order.
+ *  3. Node data updates are applied.
+ *
+ *  The network ends up with the same nodes, edges and data as if the
+ *  changes were made one by one, but edge indices may differ. If a
+ *  change fails, the changes already made are rolled back before the
+ *  exception is rethrown, so a commit is all or nothing.
+ *
+ *  A DeltaLog records what a commit did. It can roll the changes back,
+ *  for example to reject a Monte Carlo move, or replay them on another
+ *  network.
+ *  For further usage, check out http://doc.hxtcloud.cn.
+ */
+
+#ifndef CIMNET_BATCH
+#define CIMNET_BATCH
+
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <utility>
+
+#include "_base_net.h"
+
+
+/* One change recorded in a DeltaLog */
+template <class _NId=Id, class _NData=None, class _EData=None>
+struct Delta {
+    enum Kind {NODE_ADDED, NODE_CHANGED, EDGE_ADDED, EDGE_REMOVED, EDGE_CHANGED};
+
+    Delta(Kind k, const _NId &id1, const _NId &id2)
+        : kind(k), first(id1), second(id2), old_node(), new_node(), old_edge(), new_edge() {}
+
+    Kind kind;
+    _NId first;
+    _NId second;        /* unused for node changes */
+    _NData old_node;
+    _NData new_node;
+    _EData old_edge;
+    _EData new_edge;
+};
+
+
+/* Changes made by commits, in order */
+template <class _NId=Id, class _NData=None, class _EData=None>
+class DeltaLog {
+    template <class, class, class> friend class Batch;
+
+    public:
+    typedef Delta<_NId, _NData, _EData> _DeltaType;
+
+    DeltaLog () : _deltas() {}
+
+    inline const std::vector<_DeltaType> &deltas() const {
+        return _deltas;
+    }
+
+    inline int size() const {
+        return _deltas.size();
+    }
+
+    inline bool empty() const {
+        return _deltas.empty();
+    }
+
+    inline void clear() {
+        _deltas.clear();
+    }
+
+    /* Undo all recorded changes on net, latest first, and empty the
+     * log. */
+    template <class _Net>
+    inline void rollback(_Net &net) {
+        _rollback(net, 0);
+    }
+
+    /* Make all recorded changes again on net, which should be in the
+     * state the log started from. */
+    template <class _Net>
+    inline void replay(_Net &net) const {
+        for (const auto &d : _deltas) {
+            switch (d.kind) {
+                case _DeltaType::NODE_ADDED:   net.add_node(d.first); break;
+                case _DeltaType::NODE_CHANGED: net.node(d.first) = d.new_node; break;
+                case _DeltaType::EDGE_ADDED:   net.add_edge(d.first, d.second, d.new_edge); break;
+                case _DeltaType::EDGE_REMOVED: net.remove_edge(d.first, d.second); break;
+                case _DeltaType::EDGE_CHANGED: net.edge(d.first, d.second) = d.new_edge; break;
+            }
+        }
+    }
+
+    private:
+    /* Undo changes from position from on, and drop them. */
+    template <class _Net>
+    inline void _rollback(_Net &net, std::size_t from) {
+        while (_deltas.size() > from) {
+            const _DeltaType &d = _deltas.back();
+            switch (d.kind) {
+                case _DeltaType::NODE_ADDED:   net.remove_node(d.first); break;
+                case _DeltaType::NODE_CHANGED: net.node(d.first) = d.old_node; break;
+                case _DeltaType::EDGE_ADDED:   net.remove_edge(d.first, d.second); break;
+                case _DeltaType::EDGE_REMOVED: net.add_edge(d.first, d.second, d.old_edge); break;
+                case _DeltaType::EDGE_CHANGED: net.edge(d.first, d.second) = d.old_edge; break;
+            }
+            _deltas.pop_back();
+        }
+    }
+
+    inline void _node_added(const _NId &id) {
+        _deltas.push_back(_DeltaType(_DeltaType::NODE_ADDED, id, id));
+    }
+
+    inline void _node_changed(const _NId &id, const _NData &old_data, const _NData &new_data) {
+        _deltas.push_back(_DeltaType(_DeltaType::NODE_CHANGED, id, id));
+        _deltas.back().old_node = old_data;
+        _deltas.back().new_node = new_data;
+    }
+
+    inline void _edge_changed(typename _DeltaType::Kind kind, const _NId &id1, const _NId &id2,
+            const _EData &old_data, const _EData &new_data) {
+        _deltas.push_back(_DeltaType(kind, id1, id2));
+        _deltas.back().old_edge = old_data;
+        _deltas.back().new_edge = new_data;
+    }
+
+    std::vector<_DeltaType> _deltas;
+};
+
+
+/* Changes to be committed to a network at once */
+template <class _NId=Id, class _NData=None, class _EData=None>
+class Batch {
+    enum _Kind {_ADD, _REMOVE, _SET};
+
+    struct _Change {
+        _Change(_Kind k, const _NId &id1, const _NId &id2, const _EData &edge_data)
+            : kind(k), first(id1), second(id2), data(edge_data) {}
+
+        _Kind kind;
+        _NId first;
+        _NId second;
+        _EData data;
+    };
+
+    public:
+    typedef DeltaLog<_NId, _NData, _EData> _LogType;
+
+    Batch () : _changes(), _node_changes() {}
+
+    /* Same as Network::add_edge: adds missing end nodes, and replaces
+     * the data of an existing edge. */
+    inline void add_edge(const _NId &id1, const _NId &id2,
+            const _EData &edge_data=_EData()) {
+        _changes.push_back(_Change(_ADD, id1, id2, edge_data));
+    }
+
+    /* Same as remove_edge: the edge should exist when it is reached. */
+    inline void remove_edge(const _NId &id1, const _NId &id2) {
+        _changes.push_back(_Change(_REMOVE, id1, id2, _EData()));
+    }
+
+    /* Same as net(id1, id2) = edge_data. */
+    inline void set_edge_data(const _NId &id1, const _NId &id2, const _EData &edge_data) {
+        _changes.push_back(_Change(_SET, id1, id2, edge_data));
+    }
+
+    /* Same as net[id] = node_data, applied after all edge changes. */
+    inline void set_node_data(const _NId &id, const _NData &node_data) {
+        _node_changes.push_back(std::make_pair(id, node_data));
+    }
+
+    /* Append the changes of another batch, e.g. one filled by another
+     * thread. */
+    inline void append(const Batch &other) {
+        _changes.insert(_changes.end(), other._changes.begin(), other._changes.end());
+        _node_changes.insert(_node_changes.end(), other._node_changes.begin(), other._node_changes.end());
+    }
+
+    inline void reserve(int n_changes) {
+        _changes.reserve(n_changes);
+    }
+
+    inline int size() const {
+        return _changes.size() + _node_changes.size();
+    }
+
+    inline bool empty() const {
+        return size() == 0;
+    }
+
+    inline void clear() {
+        _changes.clear();
+        _node_changes.clear();
+    }
+
+    /* Apply all changes to net, recording them in log if given. The
+     * batch is kept, so it could be committed to other networks. */
+    template <class _Storage>
+    inline void commit(Network<_NId, _NData, _EData, _Storage> &net, _LogType *log=nullptr) const {
+        _commit(net, net._adjs, net._adjs, log, false);
+    }
+
+    template <class _Storage>
+    inline void commit(DirectedNetwork<_NId, _NData, _EData, _Storage> &net, _LogType *log=nullptr) const {
+        _commit(net, net._succ, net._pred, log, true);
+    }
+
+    private:
+    /* Commit to net. Edge changes are grouped by source, whose
+     * neighbors are found in src, while the neighbors of targets are
+     * found in dst. */
+    template <class _Net, class _Adj>
+    inline void _commit(_Net &net, _Adj &src, _Adj &dst, _LogType *log, bool directed) const {
+        typedef typename _Adj::mapped_type _Nei;
+        _LogType local;
+        _LogType &out = log ? *log : local;
+        std::size_t from = out._deltas.size();
+        try {
+            for (const auto &c : _changes)
+                if (c.kind == _ADD) {
+                    _add_node(net, out, c.first);
+                    _add_node(net, out, c.second);
+                }
+            std::vector<std::pair<std::size_t, int>> order = _order(directed);
+            _Nei *nei = nullptr;
+            for (std::size_t k = 0; k < order.size(); k++) {
+                const _Change &c = _changes[order[k].second];
+                bool flip = _flipped(c, directed);
+                const _NId &s = flip ? c.second : c.first;
+                if (k == 0 || !(s == _source_of(_changes[order[k - 1].second], directed)))
+                    nei = _find(src, s);
+                _apply(net, out, nei, _find(dst, flip ? c.first : c.second), c, flip, directed);
+            }
+            for (const auto &n : _node_changes) {
+                _NData &data = net.node(n.first);
+                out._node_changed(n.first, data, n.second);
+                data = n.second;
+            }
+        } catch (...) {
+            out._rollback(net, from);
+            throw;
+        }
+    }
+
+    /* Positions of edge changes sorted by the hash of their source.
+     * Ties keep their order, so changes of the same edge, and of the
+     * same source, stay in order. */
+    inline std::vector<std::pair<std::size_t, int>> _order(bool directed) const {
+        std::vector<std::pair<std::size_t, int>> order;
+        order.reserve(_changes.size());
+        std::hash<_NId> hash;
+        for (int i = 0; i < (int)_changes.size(); i++) {
+            std::size_t h = hash(_changes[i].first);
+            if (!directed) h = std::min(h, hash(_changes[i].second));
+            order.push_back(std::make_pair(h, i));
+        }
+        std::sort(order.begin(), order.end());
+        return order;
+    }
+
+    /* Whether the source of c is its second end. Undirected edges are
+     * grouped by the end with the smaller hash. */
+    static inline bool _flipped(const _Change &c, bool directed) {
+        std::hash<_NId> hash;
+        return !directed && hash(c.second) < hash(c.first);
+    }
+
+    static inline const _NId &_source_of(const _Change &c, bool directed) {
+        return _flipped(c, directed) ? c.second : c.first;
+    }
+
+    template <class _Adj>
+    static inline typename _Adj::mapped_type *_find(_Adj &adj, const _NId &id) {
+        auto it = adj.find(id);
+        return it == adj.end() ? nullptr : &it->second;
+    }
+
+    template <class _Net>
+    static inline void _add_node(_Net &net, _LogType &out, const _NId &id) {
+        if (net.has_node(id)) return;
+        net._new_node(id, _NData());
+        out._node_added(id);
+    }
+
+    /* Apply change c, given the neighbor maps of its source and target
+     * (nullptr if absent). */
+    template <class _Net, class _Nei>
+    static inline void _apply(_Net &net, _LogType &out, _Nei *source, _Nei *target,
+            const _Change &c, bool flip, bool directed) {
+        typedef typename _LogType::_DeltaType _DeltaType;
+        if (!source) throw NoNodeException<_NId>(flip ? c.second : c.first);
+        if (!target) throw NoNodeException<_NId>(flip ? c.first : c.second);
+        _Nei &nei1 = flip ? *target : *source;   /* of c.first */
+        _Nei &nei2 = flip ? *source : *target;   /* of c.second */
+        if (c.kind == _ADD) {
+            auto r = net._link(nei1, nei2, c.first, c.second, c.data);
+            _EData &data = net._edges.data(r.first);
+            out._edge_changed(r.second ? _DeltaType::EDGE_ADDED : _DeltaType::EDGE_CHANGED,
+                    c.first, c.second, data, c.data);
+            data = c.data;
+            return;
+        }
+        auto it = source->find(flip ? c.first : c.second);
+        if (it == source->end()) throw NoEdgeException<_NId>(c.first, c.second, directed);
+        int e = it->second;
+        _EData &data = net._edges.data(e);
+        if (c.kind == _SET) {
+            out._edge_changed(_DeltaType::EDGE_CHANGED, c.first, c.second, data, c.data);
+            net._weights_changed(c.first, c.second);
+            data = c.data;
+            return;
+        }
+        out._edge_changed(_DeltaType::EDGE_REMOVED, c.first, c.second, data, _EData());
+        net._unlink(nei1, nei2, c.first, c.second, e);
+    }
+
+    std::vector<_Change> _changes;
+    std::vector<std::pair<_NId, _NData>> _node_changes;
+};
+
+#endif /* ifndef CIMNET_BATCH */
@@ -0,0 +1,403 @@
+/*
+ * This file contains code from https://github.com/hxt-tg/cimnet
+ * and is covered under the copyright and warranty notices:
+ * "Copyright (C) 2022 CimNet Developers
+ *  Xintao Hu <hxt.taoge@gmail.com>"
+ */
+
+/*
+ *  This file contains a sharded builder to construct networks with
+ *  many threads. Each worker thread appends edges to its own buffer
+ *  without any locking, and build() merges all buffers into a network:
+ *
+ *  1. Edges of every buffer are binned by the shard owning each end
+ *     node (by hash of node id).
+ *  2. Each shard fills neighbor maps of its own nodes, visiting edges
+ *     in buffer order, and detects repeated edges.
+ *  3. Distinct edges are appended to the edge table, then each shard
+ *     rewrites the edge indices in its neighbor maps.
+ *  4. Nodes and their neighbor maps are moved into the network in the
+ *     order they first appear.
+ *
+ *  The result is the same as adding the edges of buffer 0, 1, ... one
+ *  by one with add_edge, whatever the number of threads: edge indices,
+ *  edge data and the order of neighbors all match, so a build is
+ *  deterministic as long as each worker fills its buffer
+ *  deterministically.
+ *  For further usage, check out http://doc.hxtcloud.cn.
+ */
+
+#ifndef CIMNET_BUILDER
+#define CIMNET_BUILDER
+
+#include <thread>
+#include <vector>
+#include <unordered_map>
+#include <queue>
+#include <functional>
+#include <algorithm>
+#include <utility>
+
+#include "_base_net.h"
+
+
+/* Edges and nodes collected by one worker */
+template <class _NId=Id, class _NData=None, class _EData=None>
+class EdgeBuffer {
+    template <class, class, class> friend class ParallelBuilder;
+
+    public:
+    EdgeBuffer () : _edges(), _nodes() {}
+
+    inline void add_edge(const _NId &id1, const _NId &id2,
+            const _EData &edge_data=_EData()) {
+        _edges.push_back(EdgeRecord<_NId, _EData>(id1, id2, edge_data));
+    }
+
+    inline void add_node(const _NId &id,
+            const _NData &node_data=_NData()) {
+        _nodes.push_back(std::make_pair(id, node_data));
+    }
+
+    inline void reserve(int n_edges, int n_nodes=0) {
+        _edges.reserve(n_edges);
+        _nodes.reserve(n_nodes);
+    }
+
+    inline int number_of_edges() const {
+        return _edges.size();
+    }
+
+    inline int number_of_nodes() const {
+        return _nodes.size();
+    }
+
+    inline void clear() {
+        std::vector<EdgeRecord<_NId, _EData>>().swap(_edges);
+        std::vector<std::pair<_NId, _NData>>().swap(_nodes);
+    }
+
+    private:
+    std::vector<EdgeRecord<_NId, _EData>> _edges;
+    std::vector<std::pair<_NId, _NData>> _nodes;
+};
+
+
+/* Run func(0), ..., func(n - 1) on n threads. */
+template <class _Func>
+inline void _run_threads(int n, _Func func) {
+    if (n == 1) {
+        func(0);
+        return;
+    }
+    std::vector<std::thread> threads;
+    threads.reserve(n);
+    for (int t = 0; t < n; t++)
+        threads.emplace_back(func, t);
+    for (auto &th : threads)
+        th.join();
+}
+
+
+/* Builder merging per-worker edge buffers into a network */
+template <class _NId=Id, class _NData=None, class _EData=None>
+class ParallelBuilder {
+    typedef EdgeBuffer<_NId, _NData, _EData> _BufferType;
+    typedef EdgeRecord<_NId, _EData> _RecordType;
+
+    /* Nodes owned by a shard, in the order they first appear. For
+     * undirected networks _Nei is the neighbor map, and for directed
+     * ones the pair of successor and predecessor maps. */
+    template <class _Nei>
+    struct _Shard {
+        std::unordered_map<_NId, int> index;
+        std::vector<std::pair<_NId, _Nei>> nodes;
+        std::vector<long long> first_seen;   /* 2 * position + (second end) */
+
+        inline _Nei &touch(const _NId &id, long long seen, int degree_hint) {
+            auto r = index.emplace(id, (int)nodes.size());
+            if (r.second) {
+                nodes.push_back(std::make_pair(id, _Nei()));
+                first_seen.push_back(seen);
+                _reserve(nodes.back().second, degree_hint);
+            }
+            return nodes[r.first->second].second;
+        }
+
+        template <class _Map>
+        static inline void _reserve(_Map &nei, int degree_hint) {
+            if (degree_hint > 0) nei.reserve(degree_hint);
+        }
+
+        template <class _Map>
+        static inline void _reserve(std::pair<_Map, _Map> &nei, int degree_hint) {
+            if (degree_hint > 0) {
+                nei.first.reserve(degree_hint);
+                nei.second.reserve(degree_hint);
+            }
+        }
+    };
+
+    public:
+    explicit ParallelBuilder (int n_workers) : _buffers() {
+        if (n_workers <= 0)
+            throw NetworkException("Number of workers should be positive.");
+        _buffers.resize(n_workers);
+    }
+
+    /* Buffer of a worker. Each buffer should be filled by one thread. */
+    inline _BufferType &buffer(int worker) {
+        return _buffers.at(worker);
+    }
+
+    inline int n_workers() const {
+        return _buffers.size();
+    }
+
+    /* Call func(worker, buffer) for every worker, each on its own
+     * thread. */
+    template <class _Func>
+    inline void run(_Func func) {
+        _run_threads(n_workers(), [&](int w) { func(w, _buffers[w]); });
+    }
+
+    inline void clear() {
+        for (auto &b : _buffers)
+            b.clear();
+    }
+
+    /* Add all buffered edges and nodes to net with n_threads threads
+     * (0 for all hardware threads), and empty the buffers. Edges are
+     * merged in parallel into an empty network, and added one by one
+     * otherwise or with a single thread. Buffered nodes are added after
+     * edges. */
+    template <class _Storage>
+    inline void build(Network<_NId, _NData, _EData, _Storage> &net, int n_threads=0) {
+        typedef typename _Storage::template NeighborMap<_NId, int> _NeiType;
+        if (net.number_of_nodes() > 0 || _threads(n_threads) == 1) {
+            _build_serial(net);
+            return;
+        }
+        _prepare(n_threads);
+        std::vector<_Shard<_NeiType>> shards(_n_shards);
+        int hint = net._degree_hint;
+        _run_threads(_n_shards, [&](int t) {
+            _Shard<_NeiType> &shard = shards[t];
+            for (int b = 0; b < n_workers(); b++) {
+                long long base = _offsets[b];
+                for (int i : _bins[b][t]) {
+                    const _RecordType &rec = _buffers[b]._edges[i];
+                    long long p = base + i;
+                    int s1 = _owner(rec.first), s2 = _owner(rec.second);
+                    /* Both ends of an edge, in either direction, are
+                     * judged by the same shard. */
+                    bool judge = std::min(s1, s2) == t;
+                    int found = -2;
+                    if (s1 == t) {
+                        auto r = shard.touch(rec.first, 2 * p, hint).emplace(rec.second, (int)p);
+                        if (judge) found = r.second ? -1 : r.first->second;
+                    }
+                    if (s2 == t && !(s1 == t && rec.first == rec.second)) {
+                        auto r = shard.touch(rec.second, 2 * p + 1, hint).emplace(rec.first, (int)p);
+                        if (judge && s1 != t) found = r.second ? -1 : r.first->second;
+                    }
+                    _note(found, (int)p);
+                }
+            }
+        });
+        _finish_edges(net._edges);
+        _run_threads(_n_shards, [&](int t) {
+            for (auto &n : shards[t].nodes)
+                _remap(n.second);
+        });
+        _move_nodes(shards, [&](int t, int k) {
+            auto &n = shards[t].nodes[k];
+            net._nodes[n.first] = _NData();
+            net._adjs[n.first] = std::move(n.second);
+        }, [&](int n_nodes) {
+            net._reserve_nodes(n_nodes);
+        });
+        net._retally();
+        _finish_nodes(net);
+    }
+
+    template <class _Storage>
+    inline void build(DirectedNetwork<_NId, _NData, _EData, _Storage> &net, int n_threads=0) {
+        typedef typename _Storage::template NeighborMap<_NId, int> _NeiType;
+        typedef std::pair<_NeiType, _NeiType> _SuccPredType;
+        if (net.number_of_nodes() > 0 || _threads(n_threads) == 1) {
+            _build_serial(net);
+            return;
+        }
+        _prepare(n_threads);
+        std::vector<_Shard<_SuccPredType>> shards(_n_shards);
+        int hint = net._degree_hint;
+        _run_threads(_n_shards, [&](int t) {
+            _Shard<_SuccPredType> &shard = shards[t];
+            for (int b = 0; b < n_workers(); b++) {
+                long long base = _offsets[b];
+                for (int i : _bins[b][t]) {
+                    const _RecordType &rec = _buffers[b]._edges[i];
+                    long long p = base + i;
+                    int found = -2;
+                    /* Repeats are judged by the source. */
+                    if (_owner(rec.first) == t) {
+                        auto r = shard.touch(rec.first, 2 * p, hint).first.emplace(rec.second, (int)p);
+                        found = r.second ? -1 : r.first->second;
+                    }
+                    if (_owner(rec.second) == t)
+                        shard.touch(rec.second, 2 * p + 1, hint).second.emplace(rec.first, (int)p);
+                    _note(found, (int)p);
+                }
+            }
+        });
+        _finish_edges(net._edges);
+        _run_threads(_n_shards, [&](int t) {
+            for (auto &n : shards[t].nodes) {
+                _remap(n.second.first);
+                _remap(n.second.second);
+            }
+        });
+        _move_nodes(shards, [&](int t, int k) {
+            auto &n = shards[t].nodes[k];
+            net._nodes[n.first] = _NData();
+            net._succ[n.first] = std::move(n.second.first);
+            net._pred[n.first] = std::move(n.second.second);
+        }, [&](int n_nodes) {
+            net._reserve_nodes(n_nodes);
+        });
+        net._retally();
+        if (net._reciprocal)
+            net.enable_reciprocal_index(true);
+        _finish_nodes(net);
+    }
+
+    private:
+    inline int _owner(const _NId &id) const {
+        return std::hash<_NId>()(id) % _n_shards;
+    }
+
+    static inline int _threads(int n_threads) {
+        if (n_threads <= 0) n_threads = std::thread::hardware_concurrency();
+        return std::max(n_threads, 1);
+    }
+
+    /* Bin edges of every buffer by owning shards, and reset the
+     * bookkeeping of repeated edges. */
+    inline void _prepare(int n_threads) {
+        _n_shards = _threads(n_threads);
+        int n_buffers = n_workers();
+        _offsets.assign(n_buffers + 1, 0);
+        for (int b = 0; b < n_buffers; b++)
+            _offsets[b + 1] = _offsets[b] + _buffers[b]._edges.size();
+        if (_offsets[n_buffers] > 0x7fffffffLL)
+            throw NetworkException("Too many edges to build at once.");
+        int total = _offsets[n_buffers];
+        _first.assign(total, 0);
+        _last.assign(total, -1);
+        _bins.assign(n_buffers, std::vector<std::vector<int>>(_n_shards));
+        int n_binning = std::min(_n_shards, n_buffers);
+        _run_threads(n_binning, [&](int t) {
+            for (int b = t; b < n_buffers; b += n_binning) {
+                const auto &edges = _buffers[b]._edges;
+                for (int i = 0; i < (int)edges.size(); i++) {
+                    int s1 = _owner(edges[i].first), s2 = _owner(edges[i].second);
+                    _bins[b][s1].push_back(i);
+                    if (s2 != s1) _bins[b][s2].push_back(i);
+                }
+            }
+        });
+    }
+
+    /* Record the edge at p: found is -1 if it is new, the position of
+     * its first occurrence if it is repeated, and -2 if this shard
+     * does not judge it. */
+    inline void _note(int found, int p) {
+        if (found == -1)
+            _first[p] = 1;
+        else if (found >= 0)
+            _last[found] = p;
+    }
+
+    inline const _RecordType &_record(int p) const {
+        int b = std::upper_bound(_offsets.begin(), _offsets.end(), (long long)p) - _offsets.begin() - 1;
+        return _buffers[b]._edges[p - _offsets[b]];
+    }
+
+    /* Append first occurrences to the edge table, with the data of the
+     * last occurrence, and turn _last into position -> edge index. */
+    inline void _finish_edges(EdgeTable<_NId, _EData> &table) {
+        int p = 0;
+        for (int b = 0; b < n_workers(); b++)
+            for (const auto &rec : _buffers[b]._edges) {
+                if (_first[p]) {
+                    int src = _last[p];
+                    _last[p] = table.insert(rec.first, rec.second,
+                            src == -1 ? rec.payload() : _record(src).payload());
+                }
+                ++p;
+            }
+    }
+
+    template <class _Map>
+    inline void _remap(_Map &nei) const {
+        for (auto &x : nei)
+            x.second = _last[x.second];
+    }
+
+    /* Call move(shard, k) for all nodes of all shards in the order
+     * they first appear. */
+    template <class _Nei, class _Move, class _Reserve>
+    inline void _move_nodes(std::vector<_Shard<_Nei>> &shards, _Move move, _Reserve reserve) {
+        typedef std::pair<long long, int> _HeadType;   /* first seen, shard */
+        std::priority_queue<_HeadType, std::vector<_HeadType>, std::greater<_HeadType>> heads;
+        std::vector<int> next(shards.size(), 0);
+        int n_nodes = 0;
+        for (int t = 0; t < (int)shards.size(); t++) {
+            n_nodes += shards[t].nodes.size();
+            if (!shards[t].nodes.empty())
+                heads.push(std::make_pair(shards[t].first_seen[0], t));
+        }
+        reserve(n_nodes);
+        while (!heads.empty()) {
+            int t = heads.top().second;
+            heads.pop();
+            move(t, next[t]++);
+            if (next[t] < (int)shards[t].nodes.size())
+                heads.push(std::make_pair(shards[t].first_seen[next[t]], t));
+        }
+    }
+
+    template <class _Net>
+    inline void _finish_nodes(_Net &net) {
+        for (auto &buf : _buffers)
+            for (auto &n : buf._nodes)
+                net.add_node(n.first, n.second);
+        _release();
+    }
+
+    template <class _Net>
+    inline void _build_serial(_Net &net) {
+        for (auto &buf : _buffers)
+            for (auto &rec : buf._edges)
+                net.add_edge(rec.first, rec.second, rec.payload());
+        _finish_nodes(net);
+    }
+
+    inline void _release() {
+        clear();
+        std::vector<long long>().swap(_offsets);
+        std::vector<char>().swap(_first);
+        std::vector<int>().swap(_last);
+        std::vector<std::vector<std::vector<int>>>().swap(_bins);
+    }
+
+    std::vector<_BufferType> _buffers;
+    int _n_shards = 1;
+    std::vector<long long> _offsets;            /* first position of each buffer */
+    std::vector<char> _first;                   /* position -> is first occurrence */
+    std::vector<int> _last;                     /* position -> last occurrence, later edge index */
+    std::vector<std::vector<std::vector<int>>> _bins;   /* buffer -> shard -> offsets */
+};
+
+#endif /* ifndef CIMNET_BUILDER */
@@ -0,0 +1,513 @@
+/*
+ * This file contains code from https://github.com/hxt-tg/cimnet
+ * and is covered under the copyright and warranty notices:
+ * "Copyright (C) 2022 CimNet Developers
+ *  Xintao Hu <hxt.taoge@gmail.com>"
+ */
+
+/*
+ *  This file contains checkpoints, binary files holding a network (its
+ *  nodes, edges and their data) together with the states of random
+ *  engines. A run killed after save_checkpoint goes on after
+ *  load_checkpoint exactly as if it had never stopped: the network is
+ *  rebuilt with its nodes, neighbors and edges in the same order, so
+ *  iterating it and drawing from it (random_neighbor, random_edge, ...)
+ *  give the same results as in the saved run.
+ *
+ *  Node ids and data are stored as raw bytes if they are trivially
+ *  copyable, std::string by length and characters. Checkpoints are
+ *  meant to be loaded by the same program on the same kind of machine.
+ *  For hash maps of nodes (the default storage), the order is kept by
+ *  refilling them in reverse with the same number of buckets. This
+ *  relies on how libstdc++ lays out std::unordered_map and is not
+ *  promised by the standard; other standard libraries load the same
+ *  network, but may iterate and draw from it in another order.
+ *  For further usage, check out http://doc.hxtcloud.cn.
+ */
+
+#ifndef CIMNET_CHECKPOINT
+#define CIMNET_CHECKPOINT
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "_base_net.h"
+
+
+/* Output buffered in blocks, since checkpoints are written value by
+ * value. Offers write() like std::ostream, for save_state of engines. */
+class _CheckpointWriter {
+    static const std::size_t BUFFER = 1 << 16;
+
+    public:
+    explicit _CheckpointWriter (std::ostream &out) : _out(out), _buf() {
+        _buf.reserve(BUFFER);
+    }
+
+    inline _CheckpointWriter &write(const char *data, std::size_t n) {
+        if (_buf.size() + n > BUFFER) flush();
+        if (n > BUFFER) _out.write(data, n);
+        else _buf.insert(_buf.end(), data, data + n);
+        return *this;
+    }
+
+    inline void flush() {
+        _out.write(_buf.data(), _buf.size());
+        _buf.clear();
+    }
+
+    private:
+    std::ostream &_out;
+    std::vector<char> _buf;
+};
+
+/* Input read in blocks. Offers read() like std::istream, for load_state
+ * of engines. It may read past the end of the checkpoint. */
+class _CheckpointReader {
+    static const std::size_t BUFFER = 1 << 16;
+    static const std::size_t UNKNOWN = (std::size_t)-1;
+
+    public:
+    explicit _CheckpointReader (std::istream &in)
+        : _in(in), _buf(BUFFER), _pos(0), _end(0), _left(_size_left(in)), _good(true) {}
+
+    inline _CheckpointReader &read(char *data, std::size_t n) {
+        while (n > 0 && _good) {
+            if (_pos == _end) {
+                _in.read(_buf.data(), BUFFER);
+                _pos = 0;
+                _end = _in.gcount();
+                if (_left != UNKNOWN) _left -= std::min(_left, _end);
+                _good = _end > 0;
+                continue;
+            }
+            std::size_t k = n < _end - _pos ? n : _end - _pos;
+            std::memcpy(data, _buf.data() + _pos, k);
+            _pos += k; data += k; n -= k;
+        }
+        return *this;
+    }
+
+    inline explicit operator bool() const {
+        return _good;
+    }
+
+    /* Bytes left to read, or the largest size if the stream cannot
+     * tell (a pipe, say). */
+    inline std::size_t available() const {
+        return _left == UNKNOWN ? UNKNOWN : _end - _pos + _left;
+    }
+
+    private:
+    static inline std::size_t _size_left(std::istream &in) {
+        std::istream::iostate state = in.rdstate();
+        std::istream::pos_type pos = in.tellg();
+        if (pos == std::istream::pos_type(-1)) return UNKNOWN;
+        in.seekg(0, std::ios::end);
+        std::istream::pos_type end = in.tellg();
+        in.clear(state);
+        in.seekg(pos);
+        return end == std::istream::pos_type(-1) ? UNKNOWN : std::size_t(end - pos);
+    }
+
+    std::istream &_in;
+    std::vector<char> _buf;
+    std::size_t _pos, _end, _left;
+    bool _good;
+};
+
+
+/* Saving and loading of networks, a friend of both base classes */
+class _Checkpoint {
+    static const uint32_t VERSION = 1;
+    static const uint64_t AHEAD = 1 << 16;     /* most items allocated before they are read */
+
+    public:
+    template <class _NId, class _NData, class _EData, class _Storage>
+    static inline void save(_CheckpointWriter &out, const Network<_NId, _NData, _EData, _Storage> &net) {
+        _save_header<_NId, _NData, _EData>(out, false);
+        _put(out, (int32_t)net._degree_hint);
+        _save_nodes(out, net._nodes);
+        _save_edges(out, net._edges);
+        _save_neighbors(out, net._adjs);
+    }
+
+    template <class _NId, class _NData, class _EData, class _Storage>
+    static inline void save(_CheckpointWriter &out, const DirectedNetwork<_NId, _NData, _EData, _Storage> &net) {
+        _save_header<_NId, _NData, _EData>(out, true);
+        _put(out, (int32_t)net._degree_hint);
+        _put(out, (uint8_t)net._reciprocal);
+        _save_nodes(out, net._nodes);
+        _save_edges(out, net._edges);
+        _save_neighbors(out, net._succ);
+        _save_neighbors(out, net._pred);
+    }
+
+    template <class _NId, class _NData, class _EData, class _Storage>
+    static inline void load(_CheckpointReader &in, Network<_NId, _NData, _EData, _Storage> &net) {
+        _load_header<_NId, _NData, _EData>(in, false);
+        net.clear();
+        int32_t hint;
+        _get(in, hint);
+        _load_nodes(in, net._nodes);
+        _load_edges(in, net._edges);
+        _load_neighbors(in, net._adjs, net._edges, hint, [](const EdgeRecord<_NId, _EData> &rec, const _NId &id) {
+            return rec.first == id ? rec.second : rec.first;
+        });
+        net._retally();
+        net._degree_hint = hint;
+    }
+
+    template <class _NId, class _NData, class _EData, class _Storage>
+    static inline void load(_CheckpointReader &in, DirectedNetwork<_NId, _NData, _EData, _Storage> &net) {
+        _load_header<_NId, _NData, _EData>(in, true);
+        net.clear();
+        int32_t hint;
+        uint8_t reciprocal;
+        _get(in, hint);
+        _get(in, reciprocal);
+        _load_nodes(in, net._nodes);
+        _load_edges(in, net._edges);
+        _load_neighbors(in, net._succ, net._edges, hint, [](const EdgeRecord<_NId, _EData> &rec, const _NId &) {
+            return rec.second;
+        });
+        _load_neighbors(in, net._pred, net._edges, hint, [](const EdgeRecord<_NId, _EData> &rec, const _NId &) {
+            return rec.first;
+        });
+        net._retally();
+        net._degree_hint = hint;
+        if (reciprocal) net.enable_reciprocal_index(true);
+    }
+
+    /* Values */
+
+    template <class _T>
+    static inline void _put(_CheckpointWriter &out, const _T &value) {
+        static_assert(std::is_trivially_copyable<_T>::value,
+                "Checkpoints hold trivially copyable ids and data, or std::string.");
+        out.write((const char *)&value, sizeof value);
+    }
+
+    static inline void _put(_CheckpointWriter &, const None &) {}
+
+    static inline void _put(_CheckpointWriter &out, const std::string &value) {
+        _put(out, (uint64_t)value.size());
+        out.write(value.data(), value.size());
+    }
+
+    template <class _T>
+    static inline void _get(_CheckpointReader &in, _T &value) {
+        static_assert(std::is_trivially_copyable<_T>::value,
+                "Checkpoints hold trivially copyable ids and data, or std::string.");
+        if (!in.read((char *)&value, sizeof value)) _truncated();
+    }
+
+    static inline void _get(_CheckpointReader &, None &) {}
+
+    static inline void _get(_CheckpointReader &in, std::string &value) {
+        uint64_t n = _count(in, 1);
+        value.clear();
+        while (value.size() < n) {
+            std::size_t at = value.size(), k = _ahead(n - at);
+            value.resize(at + k);
+            if (!in.read(&value[at], k)) _truncated();
+        }
+    }
+
+    /* A count of items taking at least size bytes each. Counts that the
+     * rest of the stream cannot hold are refused before allocating. */
+    static inline uint64_t _count(_CheckpointReader &in, std::size_t size) {
+        uint64_t n;
+        _get(in, n);
+        if (size > 0 && n > in.available() / size) _truncated();
+        return n;
+    }
+
+    static inline uint64_t _ahead(uint64_t n) {
+        return n < AHEAD ? n : uint64_t(AHEAD);
+    }
+
+    static inline void _truncated() {
+        throw NetworkException("Checkpoint is truncated.");
+    }
+
+    private:
+    /* Fewest bytes a value takes in a checkpoint */
+    template <class _T>
+    static inline std::size_t _least(const _T *) {
+        return sizeof(_T);
+    }
+
+    static inline std::size_t _least(const None *) {
+        return 0;
+    }
+
+    static inline std::size_t _least(const std::string *) {
+        return sizeof(uint64_t);
+    }
+
+    template <class _NId, class _NData, class _EData>
+    static inline void _save_header(_CheckpointWriter &out, bool directed) {
+        out.write("CIMNETCK", 8);
+        _put(out, (uint32_t)VERSION);
+        _put(out, (uint8_t)directed);
+        _put(out, (uint32_t)sizeof(_NId));
+        _put(out, (uint32_t)sizeof(_NData));
+        _put(out, (uint32_t)sizeof(_EData));
+    }
+
+    template <class _NId, class _NData, class _EData>
+    static inline void _load_header(_CheckpointReader &in, bool directed) {
+        char magic[8];
+        uint32_t version, sizes[3];
+        uint8_t saved_directed;
+        if (!in.read(magic, 8) || std::memcmp(magic, "CIMNETCK", 8) != 0)
+            throw NetworkException("Not a checkpoint.");
+        _get(in, version);
+        if (version != VERSION)
+            throw NetworkException("Unsupported checkpoint version " + std::to_string(version) + ".");
+        _get(in, saved_directed);
+        if (saved_directed != directed)
+            throw NetworkException(saved_directed ? "Checkpoint holds a directed network."
+                                                  : "Checkpoint holds an undirected network.");
+        for (auto &s : sizes) _get(in, s);
+        if (sizes[0] != sizeof(_NId) || sizes[1] != sizeof(_NData) || sizes[2] != sizeof(_EData))
+            throw NetworkException("Checkpoint holds other types of nodes or data.");
+    }
+
+    /* Node maps are written in the order they are iterated, along with
+     * their number of buckets if they are hash maps. Refilled in reverse
+     * order with the same buckets, a hash map iterates as before, since
+     * in libstdc++ each new key goes first in its bucket and new buckets
+     * go first (not required by the standard). */
+    template <class _Map>
+    static inline std::size_t _buckets(const _Map &) {
+        return 0;
+    }
+
+    template <class _K, class _V>
+    static inline std::size_t _buckets(const std::unordered_map<_K, _V> &map) {
+        return map.bucket_count();
+    }
+
+    template <class _Map>
+    static inline void _prepare(_Map &map, std::size_t size, std::size_t) {
+        map.reserve(size);
+    }
+
+    template <class _K, class _V>
+    static inline void _prepare(std::unordered_map<_K, _V> &map, std::size_t, std::size_t buckets) {
+        map.rehash(buckets);
+    }
+
+    template <class _NType>
+    static inline void _save_nodes(_CheckpointWriter &out, const _NType &nodes) {
+        _put(out, (uint64_t)nodes.size());
+        _put(out, (uint64_t)_buckets(nodes));
+        for (const auto &n : nodes) {
+            _put(out, n.first);
+            _put(out, n.second);
+        }
+    }
+
+    template <class _NType>
+    static inline void _load_nodes(_CheckpointReader &in, _NType &nodes) {
+        typedef typename _NType::key_type _NId;
+        typedef typename _NType::mapped_type _NData;
+        uint64_t n = _count(in, std::max<std::size_t>(_least((_NId *)0) + _least((_NData *)0), 1)), buckets;
+        _get(in, buckets);
+        std::vector<std::pair<_NId, _NData>> saved;
+        saved.reserve(_ahead(n));
+        for (uint64_t k = 0; k < n; k++) {
+            saved.emplace_back();
+            _get(in, saved.back().first);
+            _get(in, saved.back().second);
+        }
+        _prepare(nodes, n, buckets);
+        for (auto it = saved.rbegin(); it != saved.rend(); ++it)
+            nodes[it->first] = std::move(it->second);
+    }
+
+    template <class _NId, class _EData>
+    static inline void _save_edges(_CheckpointWriter &out, const EdgeTable<_NId, _EData> &edges) {
+        _put(out, (uint64_t)edges.size());
+        for (int e = 0; e < edges.size(); e++) {
+            const auto &rec = edges.record(e);
+            _put(out, rec.first);
+            _put(out, rec.second);
+            _put(out, rec.payload());
+        }
+    }
+
+    template <class _NId, class _EData>
+    static inline void _load_edges(_CheckpointReader &in, EdgeTable<_NId, _EData> &edges) {
+        uint64_t m = _count(in, std::max<std::size_t>(2 * _least((_NId *)0) + _least((_EData *)0), 1));
+        _NId id1, id2;
+        _EData data;
+        for (uint64_t e = 0; e < m; e++) {
+            _get(in, id1);
+            _get(in, id2);
+            _get(in, data);
+            edges.insert(id1, id2, data);
+        }
+    }
+
+    /* Neighbors are written as the indices of their edges, in order. */
+    template <class _AdjType>
+    static inline void _save_neighbors(_CheckpointWriter &out, const _AdjType &adjs) {
+        _put(out, (uint64_t)adjs.size());
+        _put(out, (uint64_t)_buckets(adjs));
+        for (const auto &a : adjs) {
+            _put(out, a.first);
+            _put(out, (uint64_t)a.second.size());
+            for (const auto &n : a.second)
+                _put(out, (int32_t)n.second);
+        }
+    }
+
+    template <class _AdjType, class _Edges, class _End>
+    static inline void _load_neighbors(_CheckpointReader &in, _AdjType &adjs,
+            const _Edges &edges, int hint, _End other_end) {
+        typedef typename _AdjType::key_type _NId;
+        typedef typename _AdjType::mapped_type _NeiType;
+        uint64_t n = _count(in, _least((_NId *)0) + sizeof(uint64_t)), buckets;
+        _get(in, buckets);
+        std::vector<std::pair<_NId, uint64_t>> nodes;
+        std::vector<int32_t> indices;
+        nodes.reserve(_ahead(n));
+        for (uint64_t k = 0; k < n; k++) {
+            nodes.emplace_back();
+            _get(in, nodes.back().first);
+            nodes.back().second = indices.size();
+            uint64_t left = _count(in, sizeof(int32_t));
+            while (left > 0) {
+                std::size_t at = indices.size(), step = _ahead(left);
+                indices.resize(at + step);
+                if (!in.read((char *)&indices[at], step * sizeof(int32_t))) _truncated();
+                left -= step;
+            }
+        }
+        for (int32_t e : indices)
+            if (e < 0 || e >= edges.size()) throw NetworkException("Checkpoint is corrupt.");
+        _prepare(adjs, n, buckets);
+        uint64_t end = indices.size();
+        for (auto it = nodes.rbegin(); it != nodes.rend(); ++it) {
+            _NeiType &nei = adjs[it->first];
+            nei.reserve(std::max<std::size_t>(end - it->second, hint > 0 ? hint : 0));
+            for (uint64_t k = it->second; k < end; k++)
+                nei.emplace(other_end(edges.record(indices[k]), it->first), indices[k]);
+            end = it->second;
+        }
+    }
+};
+
+
+/* ENGINES */
+
+template <class _Rng>
+inline void _save_engine(_CheckpointWriter &out, const _Rng &rng) {
+    rng.save_state(out);
+}
+
+template <class _Rng>
+inline void _save_engine(_CheckpointWriter &out, const std::vector<_Rng> &rngs) {
+    _Checkpoint::_put(out, (uint64_t)rngs.size());
+    for (const auto &rng : rngs)
+        rng.save_state(out);
+}
+
+template <class _Rng>
+inline void _load_engine(_CheckpointReader &in, _Rng &rng) {
+    if (!rng.load_state(in))
+        throw NetworkException("Checkpoint does not match the given engines.");
+}
+
+/* A vector of engines, such as random_streams, must already have the
+ * saved number of engines. */
+template <class _Rng>
+inline void _load_engine(_CheckpointReader &in, std::vector<_Rng> &rngs) {
+    uint64_t n;
+    _Checkpoint::_get(in, n);
+    if (n != rngs.size())
+        throw NetworkException("Checkpoint holds " + std::to_string(n) + " engines, not "
+                + std::to_string(rngs.size()) + ".");
+    for (auto &rng : rngs)
+        _load_engine(in, rng);
+}
+
+inline void _save_engines(_CheckpointWriter &out) {
+    out.write("CIMNETRN", 8);
+}
+
+template <class _Rng, class... _Rngs>
+inline void _save_engines(_CheckpointWriter &out, const _Rng &rng, const _Rngs &... rngs) {
+    _save_engine(out, rng);
+    _save_engines(out, rngs...);
+}
+
+/* The engines end with a mark, so that loading into other engines than
+ * were saved is noticed. */
+inline void _load_engines(_CheckpointReader &in) {
+    char mark[8];
+    if (!in.read(mark, 8) || std::memcmp(mark, "CIMNETRN", 8) != 0)
+        throw NetworkException("Checkpoint does not match the given engines.");
+}
+
+template <class _Rng, class... _Rngs>
+inline void _load_engines(_CheckpointReader &in, _Rng &rng, _Rngs &... rngs) {
+    _load_engine(in, rng);
+    _load_engines(in, rngs...);
+}
+
+
+/* SAVE AND LOAD CHECKPOINTS */
+
+/* Write net and the states of the engines rngs (engines or vectors of
+ * engines) to out, opened in binary mode. */
+template <class _Net, class... _Rngs>
+void save_checkpoint(std::ostream &out, const _Net &net, const _Rngs &... rngs) {
+    _CheckpointWriter writer(out);
+    _Checkpoint::save(writer, net);
+    _save_engines(writer, rngs...);
+    writer.flush();
+    if (!out) throw NetworkException("Cannot write checkpoint.");
+}
+
+/* Replace net and the states of rngs by those saved in in. The network
+ * and engines are left unspecified if loading fails. */
+template <class _Net, class... _Rngs>
+void load_checkpoint(std::istream &in, _Net &net, _Rngs &... rngs) {
+    _CheckpointReader reader(in);
+    _Checkpoint::load(reader, net);
+    _load_engines(reader, rngs...);
+}
+
+/* Save to the file path. The checkpoint is written to path.tmp first
+ * and then renamed, so a run killed while saving keeps the previous
+ * checkpoint intact. */
+template <class _Net, class... _Rngs>
+void save_checkpoint(const std::string &path, const _Net &net, const _Rngs &... rngs) {
+    std::string tmp = path + ".tmp";
+    std::ofstream out(tmp, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out) throw NetworkException("Cannot write checkpoint \"" + tmp + "\".");
+    save_checkpoint(out, net, rngs...);
+    out.close();
+    if (!out || std::rename(tmp.c_str(), path.c_str()) != 0)
+        throw NetworkException("Cannot write checkpoint \"" + path + "\".");
+}
+
+template <class _Net, class... _Rngs>
+void load_checkpoint(const std::string &path, _Net &net, _Rngs &... rngs) {
+    std::ifstream in(path, std::ios::in | std::ios::binary);
+    if (!in) throw NetworkException("Cannot read checkpoint \"" + path + "\".");
+    load_checkpoint(in, net, rngs...);
+}
+
+#endif /* ifndef CIMNET_CHECKPOINT */
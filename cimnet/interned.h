@@ -0,0 +1,753 @@
+/*
+ * This file contains code from https://github.com/hxt-tg/cimnet
+ * and is covered under the copyright and warranty notices:
+ * "Copyright (C) 2022 CimNet Developers
+ *  Xintao Hu <hxt.taoge@gmail.com>"
+ */
+
+/*
+ *  This file contains networks with interned node ids. Each external
+ *  node id (such as a std::string) is mapped to a dense integer once
+ *  when the node is added, and the topology is kept in a network keyed
+ *  by those integers with DenseStorage. Ids are translated back only at
+ *  the interface, so adjacency stores no copies of external ids and
+ *  neighbor lookups never hash them.
+ *  For further usage, check out http://doc.hxtcloud.cn.
+ */
+
+#ifndef CIMNET_INTERNED
+#define CIMNET_INTERNED
+
+#include <utility>
+
+#include "_base_net.h"
+
+
+/* Table of interned ids. Internal ids of removed nodes are reused. */
+template <class _NId>
+class IdTable {
+    public:
+    IdTable () : _ids(), _index(), _free() {}
+
+    /* Internal id of id, interning it if new. */
+    inline int intern(const _NId &id) {
+        auto it = _index.find(id);
+        if (it != _index.end()) return it->second;
+        int k;
+        if (!_free.empty()) {
+            k = _free.back();
+            _free.pop_back();
+            _ids[k] = id;
+        } else {
+            k = _ids.size();
+            _ids.push_back(id);
+        }
+        _index.emplace(id, k);
+        return k;
+    }
+
+    /* Internal id of id, or -1 if not interned. */
+    inline int find(const _NId &id) const {
+        auto it = _index.find(id);
+        return it == _index.end() ? -1 : it->second;
+    }
+
+    inline const _NId &id_of(int k) const {
+        return _ids[k];
+    }
+
+    inline void release(const _NId &id) {
+        auto it = _index.find(id);
+        if (it == _index.end()) return;
+        _free.push_back(it->second);
+        _ids[it->second] = _NId();    /* free heavy ids now */
+        _index.erase(it);
+    }
+
+    inline void reserve(int n) {
+        _ids.reserve(n);
+        _index.reserve(n);
+    }
+
+    inline void clear() {
+        std::vector<_NId>().swap(_ids);
+        std::unordered_map<_NId, int>().swap(_index);
+        std::vector<int>().swap(_free);
+    }
+
+    inline int size() const {
+        return _index.size();
+    }
+
+    inline const std::vector<_NId> &ids() const {
+        return _ids;
+    }
+
+    /* Estimated bytes, see NetworkStats. */
+    inline std::size_t memory_usage() const {
+        return sizeof(*this) - sizeof(_index) + _container_stats(_index).bytes
+            + _heap_bytes(_ids.capacity() * sizeof(_NId))
+            + _heap_bytes(_free.capacity() * sizeof(int));
+    }
+
+    private:
+    std::vector<_NId> _ids;
+    std::unordered_map<_NId, int> _index;
+    std::vector<int> _free;
+};
+
+
+/* View translating internal ids yielded by another view */
+template <class _NId, class _Iter>
+class InternedViewIterator {
+public:
+    explicit InternedViewIterator(const _Iter &iterator, const std::vector<_NId> *ids)
+            : _iter{iterator}, _ids{ids} {}
+
+    bool operator!=(const InternedViewIterator &other) const {
+        return _iter != other._iter;
+    }
+
+    const _NId &operator*() const {
+        return (*_ids)[*_iter];
+    }
+
+    const InternedViewIterator &operator++() {
+        ++_iter;
+        return *this;
+    }
+
+private:
+    _Iter _iter;
+    const std::vector<_NId> *_ids{};
+};
+
+template <class _NId, class _View>
+class InternedView {
+public:
+    using _Iter = decltype(std::declval<const _View &>().begin());
+    using _InternedViewIterator = InternedViewIterator<_NId, _Iter>;
+
+    explicit InternedView(const _View &view, const std::vector<_NId> &ids)
+            : _view(view), _ids(&ids) {}
+
+    _InternedViewIterator begin() const {
+        return _InternedViewIterator(_view.begin(), _ids);
+    }
+
+    _InternedViewIterator end() const {
+        return _InternedViewIterator(_view.end(), _ids);
+    }
+
+private:
+    _View _view;
+    const std::vector<_NId> *_ids{};
+};
+
+/* Edges view translating internal ids. Ends of undirected edges are
+ * given in ascending order of external ids. */
+template <class _NId, class _Iter, bool _Directed>
+class InternedEdgesViewIterator {
+public:
+    explicit InternedEdgesViewIterator(const _Iter &iterator, const std::vector<_NId> *ids)
+            : _iter{iterator}, _ids{ids} {}
+
+    bool operator!=(const InternedEdgesViewIterator &other) const {
+        return _iter != other._iter;
+    }
+
+    std::pair<_NId, _NId> operator*() const {
+        std::pair<int, int> e = *_iter;
+        const _NId &id1 = (*_ids)[e.first], &id2 = (*_ids)[e.second];
+        if (!_Directed && id2 < id1)
+            return std::make_pair(id2, id1);
+        return std::make_pair(id1, id2);
+    }
+
+    const InternedEdgesViewIterator &operator++() {
+        ++_iter;
+        return *this;
+    }
+
+private:
+    _Iter _iter;
+    const std::vector<_NId> *_ids{};
+};
+
+template <class _NId, class _View, bool _Directed>
+class InternedEdgesView {
+public:
+    using _Iter = decltype(std::declval<const _View &>().begin());
+    using _InternedEdgesViewIterator = InternedEdgesViewIterator<_NId, _Iter, _Directed>;
+
+    explicit InternedEdgesView(const _View &view, const std::vector<_NId> &ids)
+            : _view(view), _ids(&ids) {}
+
+    _InternedEdgesViewIterator begin() const {
+        return _InternedEdgesViewIterator(_view.begin(), _ids);
+    }
+
+    _InternedEdgesViewIterator end() const {
+        return _InternedEdgesViewIterator(_view.end(), _ids);
+    }
+
+private:
+    _View _view;
+    const std::vector<_NId> *_ids{};
+};
+
+
+/* Undirected network with interned node ids */
+template <class _NId=Id, class _NData=None, class _EData=None>
+class InternedNetwork {
+    typedef Network<int, _NData, _EData, DenseStorage> _InnerType;
+    typedef std::pair<_NId, _NId> _EPairType;
+    typedef std::unordered_set<std::pair<_NId, _NId>, HashPair> _ESetType;
+
+    friend std::ostream& operator<<(std::ostream& out, const InternedNetwork& net) {
+        out << "Interned network {#(node)=" << net.number_of_nodes()
+            << ", #(edge)=" << net.number_of_edges()
+            << ", #(degree)=" << net.total_degree() << "}";
+        return out;
+    }
+
+    public:
+    InternedNetwork () : _table(), _net(), _degree_hint(0) {}
+
+    inline _NId add_node(const _NId &id,
+            const _NData &node_data=_NData()) {
+        _net.add_node(_table.intern(id), node_data);
+        return id;
+    }
+
+    template <class _Iter>
+    inline void add_nodes_from(_Iter begin, _Iter end,
+            const _NData &node_data=_NData()) {
+        _reserve_nodes(number_of_nodes() + _count_hint(begin, end));
+        for (; begin != end; ++begin)
+            add_node(*begin, node_data);
+    }
+
+    inline void add_edge(const _NId &id1, const _NId &id2,
+            const _EData &edge_data=_EData()) {
+        int k1 = _table.intern(id1);
+        _net.add_edge(k1, _table.intern(id2), edge_data);
+    }
+
+    template <class _Iter>
+    inline void add_edges_from(_Iter begin, _Iter end,
+            int n_nodes=0, int degree=0) {
+        int hint = _degree_hint;
+        reserve(n_nodes, degree);
+        for (; begin != end; ++begin)
+            add_edge(std::get<0>(*begin), std::get<1>(*begin), _edge_data_of<_EData>(*begin));
+        reserve(0, hint);
+    }
+
+    inline void reserve(int n_nodes, int degree=0) {
+        _reserve_nodes(n_nodes);
+        _net.reserve(n_nodes, degree);
+        _degree_hint = degree;
+    }
+
+    inline void remove_edge(const _NId &id1, const _NId &id2) {
+        int k1 = _internal(id1), k2 = _internal(id2);
+        if (!_net.has_edge(k1, k2)) throw NoEdgeException<_NId>(id1, id2);
+        _net.remove_edge(k1, k2);
+    }
+
+    inline void remove_node(const _NId &id) {
+        _net.remove_node(_internal(id));
+        _table.release(id);
+    }
+
+    inline void clear() {
+        _net.clear();
+        _table.clear();
+        _degree_hint = 0;
+    }
+
+    inline bool has_node(const _NId &id) const {
+        return _table.find(id) != -1;
+    }
+
+    inline bool has_edge(const _NId &id1, const _NId &id2) const {
+        int k1 = _table.find(id1), k2 = _table.find(id2);
+        return k1 != -1 && k2 != -1 && _net.has_edge(k1, k2);
+    }
+
+    inline bool is_neighbor(const _NId &id1, const _NId &id2) const {
+        return has_edge(id1, id2);
+    }
+
+    inline _NData &node(const _NId &id) {
+        return _net.node(_internal(id));
+    }
+
+    inline _NData get_node_data(const _NId &id) const {
+        return _net.get_node_data(_internal(id));
+    }
+
+    inline _EData &edge(const _NId &id1, const _NId &id2) {
+        int k1 = _internal(id1), k2 = _internal(id2);
+        try {
+            return _net.edge(k1, k2);
+        } catch (NoEdgeException<int> &e) {
+            throw NoEdgeException<_NId>(id1, id2);
+        }
+    }
+
+    inline _EData get_edge_data(const _NId &id1, const _NId &id2) const {
+        int k1 = _internal(id1), k2 = _internal(id2);
+        try {
+            return _net.get_edge_data(k1, k2);
+        } catch (NoEdgeException<int> &e) {
+            throw NoEdgeException<_NId>(id1, id2);
+        }
+    }
+
+    inline int number_of_nodes() const {
+        return _net.number_of_nodes();
+    }
+
+    inline int number_of_edges() const {
+        return _net.number_of_edges();
+    }
+
+    inline int total_degree() const {
+        return _net.total_degree();
+    }
+
+    inline int degree(const _NId &id) const {
+        int k = _table.find(id);
+        return k == -1 ? 0 : _net.degree(k);
+    }
+
+    inline std::vector<_NId> neighbors(const _NId &id) const {
+        std::vector<_NId> nei;
+        if (has_node(id))
+            for (auto &n : iterate_neighbors(id))
+                nei.push_back(n);
+        return nei;
+    }
+
+    inline InternedView<_NId, NeighborView<int, _NData, _EData, DenseStorage>>
+    iterate_neighbors(const _NId &id) const {
+        return InternedView<_NId, NeighborView<int, _NData, _EData, DenseStorage>>(
+                _net.iterate_neighbors(_internal(id)), _table.ids());
+    }
+
+    template <class _Rng=MTEngine>
+    inline _NId random_neighbor(const _NId &id, _Rng &rng=default_engine()) const {
+        int k = _internal(id);
+        if (_net.degree(k) == 0) throw NoNeighborsException<_NId>(id);
+        return _table.id_of(_net.random_neighbor(k, rng));
+    }
+
+    template <class _Rng=MTEngine>
+    inline _EPairType random_edge(_Rng &rng=default_engine()) const {
+        auto e = _net.random_edge(rng);
+        return std::make_pair(_table.id_of(e.first), _table.id_of(e.second));
+    }
+
+    inline std::vector<_NId> nodes() const {
+        std::vector<_NId> ids;
+        ids.reserve(number_of_nodes());
+        for (auto &id : iterate_nodes())
+            ids.push_back(id);
+        return ids;
+    }
+
+    inline InternedView<_NId, NodesView<int, _NData, _EData, DenseStorage>> iterate_nodes() const {
+        return InternedView<_NId, NodesView<int, _NData, _EData, DenseStorage>>(
+                _net.iterate_nodes(), _table.ids());
+    }
+
+    inline _ESetType edges() const {
+        _ESetType e;
+        e.reserve(number_of_edges());
+        for (auto p : iterate_edges())
+            e.insert(p);
+        return e;
+    }
+
+    inline InternedEdgesView<_NId, EdgesView<int, _EData, false>, false> iterate_edges() const {
+        return InternedEdgesView<_NId, EdgesView<int, _EData, false>, false>(
+                _net.iterate_edges(), _table.ids());
+    }
+
+    /* Statistics of the internal network. The id table is counted in
+     * other_bytes. */
+    inline NetworkStats stats(bool max_load=true) const {
+        NetworkStats s = _net.stats(max_load);
+        s.other_bytes += _table.memory_usage();
+        return s;
+    }
+
+    inline std::size_t memory_usage() const {
+        return stats(false).total_bytes();
+    }
+
+    inline FrozenNetwork<_NId, _NData, _EData> freeze() const {
+        return FrozenNetwork<_NId, _NData, _EData>(*this);
+    }
+
+    /* Internal id of a node. */
+    inline int internal_id(const _NId &id) const {
+        return _internal(id);
+    }
+
+    /* External id of an internal id. */
+    inline const _NId &external_id(int k) const {
+        return _table.id_of(k);
+    }
+
+    /* Network of internal ids. */
+    inline const _InnerType &internal() const {
+        return _net;
+    }
+
+    inline _NData &operator[](const _NId &id) {
+        return node(id);
+    }
+
+    inline _EData &operator()(const _NId &id1, const _NId &id2) {
+        return edge(id1, id2);
+    }
+
+    private:
+    inline int _internal(const _NId &id) const {
+        int k = _table.find(id);
+        if (k == -1) throw NoNodeException<_NId>(id);
+        return k;
+    }
+
+    /* Reserve room in the id table and in the inner network, keeping
+     * its degree hint. */
+    inline void _reserve_nodes(int n_nodes) {
+        if (n_nodes <= _table.size()) return;
+        _table.reserve(n_nodes);
+        _net.reserve(n_nodes, _degree_hint);
+    }
+
+    IdTable<_NId> _table;
+    _InnerType _net;
+    int _degree_hint;
+};
+
+
+/* Directed network with interned node ids */
+template <class _NId=Id, class _NData=None, class _EData=None>
+class InternedDirectedNetwork {
+    typedef DirectedNetwork<int, _NData, _EData, DenseStorage> _InnerType;
+    typedef std::pair<_NId, _NId> _EPairType;
+    typedef std::unordered_set<std::pair<_NId, _NId>, HashPair> _ESetType;
+
+    friend std::ostream& operator<<(std::ostream& out, const InternedDirectedNetwork& net) {
+        out << "Interned directed network {#(node)=" << net.number_of_nodes()
+            << ", #(edge)=" << net.number_of_edges()
+            << ", #(degree)=" << net.total_degree() << "}";
+        return out;
+    }
+
+    public:
+    InternedDirectedNetwork () : _table(), _net(), _degree_hint(0) {}
+
+    inline _NId add_node(const _NId &id,
+            const _NData &node_data=_NData()) {
+        _net.add_node(_table.intern(id), node_data);
+        return id;
+    }
+
+    template <class _Iter>
+    inline void add_nodes_from(_Iter begin, _Iter end,
+            const _NData &node_data=_NData()) {
+        _reserve_nodes(number_of_nodes() + _count_hint(begin, end));
+        for (; begin != end; ++begin)
+            add_node(*begin, node_data);
+    }
+
+    inline void add_edge(const _NId &id1, const _NId &id2,
+            const _EData &edge_data=_EData()) {
+        int k1 = _table.intern(id1);
+        _net.add_edge(k1, _table.intern(id2), edge_data);
+    }
+
+    template <class _Iter>
+    inline void add_edges_from(_Iter begin, _Iter end,
+            int n_nodes=0, int degree=0) {
+        int hint = _degree_hint;
+        reserve(n_nodes, degree);
+        for (; begin != end; ++begin)
+            add_edge(std::get<0>(*begin), std::get<1>(*begin), _edge_data_of<_EData>(*begin));
+        reserve(0, hint);
+    }
+
+    inline void reserve(int n_nodes, int degree=0) {
+        _reserve_nodes(n_nodes);
+        _net.reserve(n_nodes, degree);
+        _degree_hint = degree;
+    }
+
+    inline void remove_edge(const _NId &id1, const _NId &id2) {
+        int k1 = _internal(id1), k2 = _internal(id2);
+        if (!_net.has_edge(k1, k2)) throw NoEdgeException<_NId>(id1, id2, true);
+        _net.remove_edge(k1, k2);
+    }
+
+    inline void remove_node(const _NId &id) {
+        _net.remove_node(_internal(id));
+        _table.release(id);
+    }
+
+    inline void clear() {
+        _net.clear();
+        _table.clear();
+        _degree_hint = 0;
+    }
+
+    inline void enable_reciprocal_index(bool enable=true) {
+        _net.enable_reciprocal_index(enable);
+    }
+
+    inline bool has_reciprocal_index() const {
+        return _net.has_reciprocal_index();
+    }
+
+    inline bool has_node(const _NId &id) const {
+        return _table.find(id) != -1;
+    }
+
+    inline bool has_successor(const _NId &id1, const _NId &id2) const {
+        int k1 = _table.find(id1), k2 = _table.find(id2);
+        return k1 != -1 && k2 != -1 && _net.has_successor(k1, k2);
+    }
+
+    inline bool has_predecessor(const _NId &id1, const _NId &id2) const {
+        int k1 = _table.find(id1), k2 = _table.find(id2);
+        return k1 != -1 && k2 != -1 && _net.has_predecessor(k1, k2);
+    }
+
+    inline bool has_edge(const _NId &id1, const _NId &id2) const {
+        return has_successor(id1, id2);
+    }
+
+    inline bool is_neighbor(const _NId &id1, const _NId &id2) const {
+        return has_successor(id1, id2) || has_predecessor(id1, id2);
+    }
+
+    inline bool is_mutual(const _NId &id1, const _NId &id2) const {
+        int k1 = _table.find(id1), k2 = _table.find(id2);
+        return k1 != -1 && k2 != -1 && _net.is_mutual(k1, k2);
+    }
+
+    inline _NData &node(const _NId &id) {
+        return _net.node(_internal(id));
+    }
+
+    inline _NData get_node_data(const _NId &id) const {
+        return _net.get_node_data(_internal(id));
+    }
+
+    inline _EData &edge(const _NId &id1, const _NId &id2) {
+        int k1 = _internal(id1), k2 = _internal(id2);
+        try {
+            return _net.edge(k1, k2);
+        } catch (NoEdgeException<int> &e) {
+            throw NoEdgeException<_NId>(id1, id2, true);
+        }
+    }
+
+    inline _EData get_edge_data(const _NId &id1, const _NId &id2) const {
+        int k1 = _internal(id1), k2 = _internal(id2);
+        try {
+            return _net.get_edge_data(k1, k2);
+        } catch (NoEdgeException<int> &e) {
+            throw NoEdgeException<_NId>(id1, id2, true);
+        }
+    }
+
+    inline int number_of_nodes() const {
+        return _net.number_of_nodes();
+    }
+
+    inline int number_of_edges() const {
+        return _net.number_of_edges();
+    }
+
+    inline int total_degree() const {
+        return _net.total_degree();
+    }
+
+    inline int in_degree(const _NId &id) const {
+        int k = _table.find(id);
+        return k == -1 ? 0 : _net.in_degree(k);
+    }
+
+    inline int out_degree(const _NId &id) const {
+        int k = _table.find(id);
+        return k == -1 ? 0 : _net.out_degree(k);
+    }
+
+    inline int degree(const _NId &id) const {
+        int k = _table.find(id);
+        return k == -1 ? 0 : _net.degree(k);
+    }
+
+    inline std::vector<_NId> successors(const _NId &id) const {
+        std::vector<_NId> nei;
+        if (has_node(id))
+            for (auto &n : iterate_successors(id))
+                nei.push_back(n);
+        return nei;
+    }
+
+    inline InternedView<_NId, NeighborView<int, _NData, _EData, DenseStorage>>
+    iterate_successors(const _NId &id) const {
+        return InternedView<_NId, NeighborView<int, _NData, _EData, DenseStorage>>(
+                _net.iterate_successors(_internal(id)), _table.ids());
+    }
+
+    inline std::vector<_NId> predecessors(const _NId &id) const {
+        std::vector<_NId> nei;
+        if (has_node(id))
+            for (auto &n : iterate_predecessors(id))
+                nei.push_back(n);
+        return nei;
+    }
+
+    inline InternedView<_NId, NeighborView<int, _NData, _EData, DenseStorage>>
+    iterate_predecessors(const _NId &id) const {
+        return InternedView<_NId, NeighborView<int, _NData, _EData, DenseStorage>>(
+                _net.iterate_predecessors(_internal(id)), _table.ids());
+    }
+
+    template <class _Rng=MTEngine>
+    inline _NId random_successor(const _NId &id, _Rng &rng=default_engine()) const {
+        int k = _internal(id);
+        if (_net.out_degree(k) == 0) throw NoNeighborsException<_NId>(id);
+        return _table.id_of(_net.random_successor(k, rng));
+    }
+
+    template <class _Rng=MTEngine>
+    inline _NId random_predecessor(const _NId &id, _Rng &rng=default_engine()) const {
+        int k = _internal(id);
+        if (_net.in_degree(k) == 0) throw NoNeighborsException<_NId>(id);
+        return _table.id_of(_net.random_predecessor(k, rng));
+    }
+
+    template <class _Rng=MTEngine>
+    inline _EPairType random_edge(_Rng &rng=default_engine()) const {
+        auto e = _net.random_edge(rng);
+        return std::make_pair(_table.id_of(e.first), _table.id_of(e.second));
+    }
+
+    inline std::vector<_NId> neighbors(const _NId &id) const {
+        std::vector<_NId> nei;
+        if (has_node(id))
+            for (auto &n : iterate_neighbors(id))
+                nei.push_back(n);
+        return nei;
+    }
+
+    inline InternedView<_NId, DiNeighborView<int, _NData, _EData, DenseStorage>>
+    iterate_neighbors(const _NId &id) const {
+        return InternedView<_NId, DiNeighborView<int, _NData, _EData, DenseStorage>>(
+                _net.iterate_neighbors(_internal(id)), _table.ids());
+    }
+
+    inline std::vector<_NId> mutual_neighbors(const _NId &id) const {
+        std::vector<_NId> nei;
+        int k = _table.find(id);
+        if (k != -1)
+            for (auto n : _net.mutual_neighbors(k))
+                nei.push_back(_table.id_of(n));
+        return nei;
+    }
+
+    inline std::vector<_NId> nodes() const {
+        std::vector<_NId> ids;
+        ids.reserve(number_of_nodes());
+        for (auto &id : iterate_nodes())
+            ids.push_back(id);
+        return ids;
+    }
+
+    inline InternedView<_NId, NodesView<int, _NData, _EData, DenseStorage>> iterate_nodes() const {
+        return InternedView<_NId, NodesView<int, _NData, _EData, DenseStorage>>(
+                _net.iterate_nodes(), _table.ids());
+    }
+
+    inline _ESetType edges() const {
+        _ESetType e;
+        e.reserve(number_of_edges());
+        for (auto p : iterate_edges())
+            e.insert(p);
+        return e;
+    }
+
+    inline InternedEdgesView<_NId, EdgesView<int, _EData, true>, true> iterate_edges() const {
+        return InternedEdgesView<_NId, EdgesView<int, _EData, true>, true>(
+                _net.iterate_edges(), _table.ids());
+    }
+
+    /* Statistics of the internal network. The id table is counted in
+     * other_bytes. */
+    inline NetworkStats stats(bool max_load=true) const {
+        NetworkStats s = _net.stats(max_load);
+        s.other_bytes += _table.memory_usage();
+        return s;
+    }
+
+    inline std::size_t memory_usage() const {
+        return stats(false).total_bytes();
+    }
+
+    inline FrozenDirectedNetwork<_NId, _NData, _EData> freeze() const {
+        return FrozenDirectedNetwork<_NId, _NData, _EData>(*this);
+    }
+
+    /* Internal id of a node. */
+    inline int internal_id(const _NId &id) const {
+        return _internal(id);
+    }
+
+    /* External id of an internal id. */
+    inline const _NId &external_id(int k) const {
+        return _table.id_of(k);
+    }
+
+    /* Network of internal ids. */
+    inline const _InnerType &internal() const {
+        return _net;
+    }
+
+    inline _NData &operator[](const _NId &id) {
+        return node(id);
+    }
+
+    inline _EData &operator()(const _NId &id1, const _NId &id2) {
+        return edge(id1, id2);
+    }
+
+    private:
+    inline int _internal(const _NId &id) const {
+        int k = _table.find(id);
+        if (k == -1) throw NoNodeException<_NId>(id);
+        return k;
+    }
+
+    /* Reserve room in the id table and in the inner network, keeping
+     * its degree hint. */
+    inline void _reserve_nodes(int n_nodes) {
+        if (n_nodes <= _table.size()) return;
+        _table.reserve(n_nodes);
+        _net.reserve(n_nodes, _degree_hint);
+    }
+
+    IdTable<_NId> _table;
+    _InnerType _net;
+    int _degree_hint;
+};
+
+#endif /* ifndef CIMNET_INTERNED */
@@ -15,55 +15,55 @@
 
 #include "_base_net.h"
 #include <fstream>
+#include <sstream>
+#include <string>
 
 /* SAVE NETWORKS */
 
-template<class _NId=Id, class _NData=None, class _EData=None>
-void save_edge_list(std::ostream &out, const Network<_NId, _NData, _EData> &net,
-                    const char *delimiter = ",") {
-    if (!out) return;
-    for (auto &e : net.edges())
-        out << e.first << delimiter << e.second << "\n";
+/* The save functions take networks and views of them (see _view_net.h).
+ * Directed ones list successors, undirected ones list neighbors. */
+template<class _Net, class _NId>
+inline std::vector<_NId> _out_neighbors(const _Net &net, const _NId &id, std::true_type) {
+    return net.successors(id);
 }
 
-template<class _NId=Id, class _NData=None, class _EData=None>
-void save_edge_list(std::ostream &out, const DirectedNetwork<_NId, _NData, _EData> &net,
-                    const char *delimiter = ",") {
-    if (!out) return;
+template<class _Net, class _NId>
+inline std::vector<_NId> _out_neighbors(const _Net &net, const _NId &id, std::false_type) {
+    return net.neighbors(id);
+}
 
-    for (auto &e : net.edges())
-        out << e.first << delimiter << e.second << "\n";
+template<class _Net, class _NId>
+inline bool _linked(const _Net &net, const _NId &id1, const _NId &id2, std::true_type) {
+    return net.has_successor(id1, id2);
 }
 
-template<class _NId=Id, class _NData=None, class _EData=None>
-void save_adjacency_list(std::ostream &out, const Network<_NId, _NData, _EData> &net,
-                         const char *delimiter = ",") {
+template<class _Net, class _NId>
+inline bool _linked(const _Net &net, const _NId &id1, const _NId &id2, std::false_type) {
+    return net.is_neighbor(id1, id2);
+}
+
+template<class _Net>
+void save_edge_list(std::ostream &out, const _Net &net, const char *delimiter = ",") {
     if (!out) return;
-    for (auto &node : net.nodes()) {
-        out << node;
-        if (net.degree(node) == 0) out << delimiter;
-        for (auto &n : net.neighbors(node))
-            out << delimiter << n;
-        out << "\n";
-    }
+    for (auto e : net.iterate_edges())
+        out << e.first << delimiter << e.second << "\n";
 }
 
-template<class _NId=Id, class _NData=None, class _EData=None>
-void save_adjacency_list(std::ostream &out, const DirectedNetwork<_NId, _NData, _EData> &net,
-                         const char *delimiter = ",") {
+template<class _Net>
+void save_adjacency_list(std::ostream &out, const _Net &net, const char *delimiter = ",") {
     if (!out) return;
     for (auto &node : net.nodes()) {
         out << node;
         if (net.degree(node) == 0) out << delimiter;
-        for (auto &n : net.successors(node))
+        for (auto &n : _out_neighbors(net, node, _IsDirected<_Net>()))
             out << delimiter << n;
         out << "\n";
     }
 }
 
-template<class _NId=Id, class _NData=None, class _EData=None>
-void save_adjacency_matrix(std::ostream &out, const Network<_NId, _NData, _EData> &net,
-                           const std::vector<_NId> &node_list, const char *delimiter = ",", bool keep_headers = true) {
+template<class _Net, class _NId>
+void save_adjacency_matrix(std::ostream &out, const _Net &net, const std::vector<_NId> &node_list,
+                           const char *delimiter = ",", bool keep_headers = true) {
     if (!out) return;
     if (keep_headers) {
         for (auto &n : node_list)
@@ -75,50 +75,79 @@ void save_adjacency_matrix(std::ostream &out, const Network<_NId, _NData, _EData
         if (keep_headers)
             out << node_list[i] << delimiter;
         for (auto j = 0UL; j < node_list.size(); j++)
-            out << "01"[net.is_neighbor(node_list[i], node_list[j])] << (j == node_list.size() - 1 ? "\n" : delimiter);
+            out << "01"[_linked(net, node_list[i], node_list[j], _IsDirected<_Net>())]
+                << (j == node_list.size() - 1 ? "\n" : delimiter);
     }
 }
 
-template<class _NId=Id, class _NData=None, class _EData=None>
-void save_adjacency_matrix(std::ostream &out, const Network<_NId, _NData, _EData> &net,
+template<class _Net>
+void save_adjacency_matrix(std::ostream &out, const _Net &net,
                            const char *delimiter = ",", bool keep_headers = true) {
     save_adjacency_matrix(out, net, net.nodes(), delimiter, keep_headers);
 }
 
-template<class _NId=Id, class _NData=None, class _EData=None>
-void save_adjacency_matrix(std::ostream &out, const DirectedNetwork<_NId, _NData, _EData> &net,
-                           const std::vector<_NId> &node_list, const char *delimiter = ",", bool keep_headers = true) {
-    if (!out) return;
-    if (keep_headers) {
-        for (auto &n : node_list)
-            out << delimiter << n;
-        out << "\n";
-    }
 
-    for (auto i = 0UL; i < node_list.size(); i++) {
-        if (keep_headers)
-            out << node_list[i] << delimiter;
-        for (auto j = 0UL; j < node_list.size(); j++)
-            out << "01"[net.has_successor(node_list[i], node_list[j])]
-                << (j == node_list.size() - 1 ? "\n" : delimiter);
-    }
+/* LOAD NETWORKS */
+
+template<class _NId>
+inline _NId _parse_node_id(const std::string &token) {
+    std::istringstream stream(token);
+    _NId id;
+    if (!(stream >> id) || !(stream >> std::ws).eof())
+        throw NetworkException("Invalid node id \"" + token + "\".");
+    return id;
 }
 
-template<class _NId=Id, class _NData=None, class _EData=None>
-void save_adjacency_matrix(std::ostream &out, const DirectedNetwork<_NId, _NData, _EData> &net,
-                           const char *delimiter = ",", bool keep_headers = true) {
-    save_adjacency_matrix(out, net, net.nodes(), delimiter, keep_headers);
+template<>
+inline std::string _parse_node_id<std::string>(const std::string &token) {
+    return token;
 }
 
+inline std::string _strip(const std::string &str) {
+    const char *blank = " \t\r\n";
+    std::size_t begin = str.find_first_not_of(blank);
+    if (begin == std::string::npos) return "";
+    return str.substr(begin, str.find_last_not_of(blank) - begin + 1);
+}
 
-/* LOAD NETWORKS */
+/* Read "id1<delimiter>id2" lines, skipping blank lines and lines
+ * starting with comment_prefix. */
+template<class _NId>
+std::vector<std::pair<_NId, _NId>> _read_edge_list(std::istream &in, const char *delimiter,
+                                                  const char *comment_prefix) {
+    std::vector<std::pair<_NId, _NId>> edges;
+    std::string line, prefix(comment_prefix), delim(delimiter);
+    while (std::getline(in, line)) {
+        line = _strip(line);
+        if (line.empty() || (!prefix.empty() && line.compare(0, prefix.size(), prefix) == 0))
+            continue;
+        std::size_t pos = line.find(delim);
+        if (pos == std::string::npos)
+            throw NetworkException("Invalid edge \"" + line + "\".");
+        edges.emplace_back(_parse_node_id<_NId>(_strip(line.substr(0, pos))),
+                           _parse_node_id<_NId>(_strip(line.substr(pos + delim.size()))));
+    }
+    return edges;
+}
 
-template<class _NId=Id, class _NData=None, class _EData=None>
-Network<_NId, _NData, _EData> load_network_from_edge_list(std::istream &out, const char *delimiter = ",",
-                                                          const char *comment_prefix = "#") {
-    if (!out) return;
-    for (auto &e : net.edges())
-        out << e.first << delimiter << e.second << "\n";
+template<class _NId=Id, class _NData=None, class _EData=None, class _Storage=HashStorage>
+Network<_NId, _NData, _EData, _Storage> load_network_from_edge_list(std::istream &in, const char *delimiter = ",",
+                                                                    const char *comment_prefix = "#") {
+    Network<_NId, _NData, _EData, _Storage> net;
+    if (!in) return net;
+    auto edges = _read_edge_list<_NId>(in, delimiter, comment_prefix);
+    net.add_edges_from(edges.begin(), edges.end());
+    return net;
+}
+
+template<class _NId=Id, class _NData=None, class _EData=None, class _Storage=HashStorage>
+DirectedNetwork<_NId, _NData, _EData, _Storage> load_directed_network_from_edge_list(std::istream &in,
+        const char *delimiter = ",", const char *comment_prefix = "#") {
+    DirectedNetwork<_NId, _NData, _EData, _Storage> net;
+    if (!in) return net;
+    auto edges = _read_edge_list<_NId>(in, delimiter, comment_prefix);
+    net.add_edges_from(edges.begin(), edges.end());
+    return net;
 }
 
 #endif /* ifndef CIMNET_IO */
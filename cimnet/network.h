@@ -12,6 +12,11 @@
  *
  *  Node labels are the integers 0 to n-1 if not specified in this docs.
  *
+ *  Each network takes a storage policy as the last template parameter
+ *  (HashStorage by default). As node labels are dense, DenseStorage
+ *  (see _storage.h) indexes nodes by label without hashing, e.g.
+ *  GridNetwork<None, None, DenseStorage>.
+ *
  *
  *  FullConnectedNetwork(int n_nodes)
  *
@@ -35,12 +40,14 @@
  *
  *
  *  ERNetwork(int n_nodes, double prob_link)
+ *  ERNetwork(int n_nodes, double prob_link, _Rng &rng)
  *
  *  Parameters
  *  n_nodes: nonnegative integer
  *      The number of nodes.
  *  prob_link: floating point number (between 0 and 1)
  *      The probability of link creation.
+ *  rng: random engine (default engine of random.h if omitted)
  *
  *  Create a Erdős-Rényi network with n_nodes nodes and
  *  choose each of possible link with probability prob_link.
@@ -125,12 +132,14 @@
  *
  *
  *  ScaleFreeNetwork(int n_nodes, int n_edges_per_node)
+ *  ScaleFreeNetwork(int n_nodes, int n_edges_per_node, _Rng &rng)
  *
  *  Parameters
  *  n_nodes: nonnegative integer
  *      The number of nodes.
  *  n_edges_per_node: nonnegative integer
  *      The number of neighbors of each node.
+ *  rng: random engine (default engine of random.h if omitted)
  *
  *  Create a scale-free (Barabási–Albert) network given the number of nodes
  *  and the number of edges per node.
@@ -152,29 +161,39 @@
 inline int mod(int x, int m) {
     return (x%m + m) % m;
 }
+
+/* Node labels 0 to n-1 */
+inline std::vector<int> node_range(int n) {
+    std::vector<int> nodes(n);
+    for (int i = 0; i < n; ++i)
+        nodes[i] = i;
+    return nodes;
+}
 /* End of Utility functions */
 
 
-template <class _NData=None, class _EData=None>
+template <class _NData=None, class _EData=None, class _Storage=HashStorage>
 class FullConnectedNetwork;
-template <class _NData, class _EData>
-class FullConnectedNetwork: public Network<int, _NData, _EData>{
+template <class _NData, class _EData, class _Storage>
+class FullConnectedNetwork: public Network<int, _NData, _EData, _Storage>{
     public:
         explicit FullConnectedNetwork(int n_nodes) {
             if (n_nodes < 0)
                 throw NetworkException("Number of nodes should be positive.");
 
+            this->reserve(n_nodes, n_nodes - 1);
             for (int i = 0; i < n_nodes; i++)
                 for (int j = i+1; j < n_nodes; j++)
                     this->add_edge(i, j);
+            this->reserve(0);
         }
 };
 
 
-template <class _NData=None, class _EData=None>
+template <class _NData=None, class _EData=None, class _Storage=HashStorage>
 class RegularNetwork;
-template <class _NData, class _EData>
-class RegularNetwork: public Network<int, _NData, _EData>{
+template <class _NData, class _EData, class _Storage>
+class RegularNetwork: public Network<int, _NData, _EData, _Storage>{
     public:
         RegularNetwork(int n_nodes, int n_links) {
             if (n_nodes < 0)
@@ -183,9 +202,11 @@ class RegularNetwork: public Network<int, _NData, _EData>{
                 throw NetworkException("Number of clockwise links should be "
                         "positive and less than number of nodes.");
 
+            this->reserve(n_nodes, 2 * n_links);
             for (int i = 0; i < n_nodes; i++)
                 for (int j = i + 1; j < i + 1 + n_links; j++)
                     this->add_edge(i, j % n_nodes);
+            this->reserve(0);
 
             this->n_links = n_links;
         }
@@ -194,23 +215,28 @@ class RegularNetwork: public Network<int, _NData, _EData>{
 };
 
 
-template <class _NData=None, class _EData=None>
+template <class _NData=None, class _EData=None, class _Storage=HashStorage>
 class ERNetwork;
-template <class _NData, class _EData>
-class ERNetwork: public Network<int, _NData, _EData>{
+template <class _NData, class _EData, class _Storage>
+class ERNetwork: public Network<int, _NData, _EData, _Storage>{
     public:
-        ERNetwork(int n_nodes, double prob_link) {
+        ERNetwork(int n_nodes, double prob_link) : ERNetwork(n_nodes, prob_link, default_engine()) {}
+
+        template <class _Rng>
+        ERNetwork(int n_nodes, double prob_link, _Rng &rng) {
             if (n_nodes < 0)
                 throw NetworkException("Number of nodes should be positive.");
             if (prob_link > 1 || prob_link < 0)
                 throw NetworkException("Probability of linking should be in [0, 1].");
 
-            for (int i = 0; i < n_nodes; ++i)
-                this->add_node(i);
+            this->reserve(n_nodes, (int)ceil(prob_link * (n_nodes - 1)));
+            std::vector<int> nodes = node_range(n_nodes);
+            this->add_nodes_from(nodes.begin(), nodes.end());
             for (int i = 0; i < n_nodes; ++i)
                 for (int j = i + 1; j < n_nodes; ++j)
-                    if (randf() < prob_link)
+                    if (rng.randf() < prob_link)
                         this->add_edge(i, j);
+            this->reserve(0);
 
             this->prob_link = prob_link;
         }
@@ -219,10 +245,10 @@ class ERNetwork: public Network<int, _NData, _EData>{
 };
 
 
-template <class _NData=None, class _EData=None>
+template <class _NData=None, class _EData=None, class _Storage=HashStorage>
 class GridNetwork;
-template <class _NData, class _EData>
-class GridNetwork: public Network<int, _NData, _EData>{
+template <class _NData, class _EData, class _Storage>
+class GridNetwork: public Network<int, _NData, _EData, _Storage>{
     public:
         GridNetwork(int width, int height, int n_neighbors=4) {
             if (width < 0 || height < 0)
@@ -231,6 +257,7 @@ class GridNetwork: public Network<int, _NData, _EData>{
                 throw NetworkException("Number of neighbors should be 4 or 8. Otherwise use CustomizableGridNetwork instead.");
 
             int w = width, h = height;
+            this->reserve(w * h, n_neighbors);
             for (int i = 0; i < h; ++i) {
                 for (int j = 0; j < w; ++j) {
                     if (n_neighbors >= 4) {
@@ -243,6 +270,7 @@ class GridNetwork: public Network<int, _NData, _EData>{
                     }
                 }
             }
+            this->reserve(0);
 
             this->width = width;
             this->height = height;
@@ -255,10 +283,10 @@ class GridNetwork: public Network<int, _NData, _EData>{
 };
 
 
-template <class _NData=None, class _EData=None>
+template <class _NData=None, class _EData=None, class _Storage=HashStorage>
 class CustomizableGridNetwork;
-template <class _NData, class _EData>
-class CustomizableGridNetwork: public Network<int, _NData, _EData> {
+template <class _NData, class _EData, class _Storage>
+class CustomizableGridNetwork: public Network<int, _NData, _EData, _Storage> {
     public:
     typedef std::pair<int, int> RangeShift;
     typedef std::vector<RangeShift> RangeMask;
@@ -271,13 +299,14 @@ class CustomizableGridNetwork: public Network<int, _NData, _EData> {
         if (width < 0 || height < 0)
             throw NetworkException("Width and height should be positive.");
         int w = width, h = height;
-        for (int x = 0; x < h; ++x)
-            for (int y = 0; y < w; ++y)
-                this->add_node(x * w + y);
+        this->reserve(w * h, mask.size());
+        std::vector<int> nodes = node_range(w * h);
+        this->add_nodes_from(nodes.begin(), nodes.end());
         for (int x = 0; x < h; ++x)
             for (int y = 0; y < w; ++y)
                 for (RangeShift &s : mask)
                     this->add_edge(x * w + y, mod(x+s.first, w) * w + mod(y+s.second, h));
+        this->reserve(0);
         this->width = width;
         this->height = height;
     }
@@ -323,16 +352,17 @@ class CustomizableGridNetwork: public Network<int, _NData, _EData> {
 };
 
 
-template <class _NData=None, class _EData=None>
+template <class _NData=None, class _EData=None, class _Storage=HashStorage>
 class CubicNetwork;
-template <class _NData, class _EData>
-class CubicNetwork: public Network<int, _NData, _EData>{
+template <class _NData, class _EData, class _Storage>
+class CubicNetwork: public Network<int, _NData, _EData, _Storage>{
     public:
         CubicNetwork(int length, int width, int height) {
             if (length < 0 || width < 0 || height < 0)
                 throw NetworkException("Length, width or height should be positive.");
 
             int h = height, w = width, l = length;
+            this->reserve(h * l * w, 6);
             for (int i = 0; i < h; ++i)
                 for (int j = 0; j < l; ++j)
                     for (int k = 0; k < w; ++k) {
@@ -340,6 +370,7 @@ class CubicNetwork: public Network<int, _NData, _EData>{
                         this->add_edge(i * w * l + ((j + l - 1) % l) * l + k, i * w * l + j * w + k);
                         this->add_edge(i * w * l + j * w + ((k + w - 1) % w), i * w * l + j * w + k);
                     }
+            this->reserve(0);
 
             this->length = length;
             this->width = width;
@@ -352,16 +383,17 @@ class CubicNetwork: public Network<int, _NData, _EData>{
 };
 
 
-template <class _NData=None, class _EData=None>
+template <class _NData=None, class _EData=None, class _Storage=HashStorage>
 class HoneycombNetwork;
-template <class _NData, class _EData>
-class HoneycombNetwork: public Network<int, _NData, _EData>{
+template <class _NData, class _EData, class _Storage>
+class HoneycombNetwork: public Network<int, _NData, _EData, _Storage>{
     public:
         HoneycombNetwork(int honeycomb_width, int honeycomb_height) {
             if (honeycomb_width < 0 || honeycomb_height < 0)
                 throw NetworkException("Width or height of honeycomb should be positive.");
 
             int w = honeycomb_width, h = honeycomb_height;
+            this->reserve(2 * w * h, 3);
             for (int i = 0; i < h; ++i) {
                 for (int j = 0; j < w; ++j) {
                     this->add_edge(2 * (i * w + j), (2 * (i * w + j) + 2 * w + 1) % (2 * w * h));
@@ -369,6 +401,7 @@ class HoneycombNetwork: public Network<int, _NData, _EData>{
                     this->add_edge(2 * i * w + ((2 * j + 1) % (2 * w)), 2 * i * w + ((2 * j + 2) % (2 * w)));
                 }
             }
+            this->reserve(0);
 
             this->honeycomb_width = honeycomb_width;
             this->honeycomb_height = honeycomb_height;
@@ -379,16 +412,17 @@ class HoneycombNetwork: public Network<int, _NData, _EData>{
 };
 
 
-template <class _NData=None, class _EData=None>
+template <class _NData=None, class _EData=None, class _Storage=HashStorage>
 class KagomeNetwork;
-template <class _NData, class _EData>
-class KagomeNetwork: public Network<int, _NData, _EData>{
+template <class _NData, class _EData, class _Storage>
+class KagomeNetwork: public Network<int, _NData, _EData, _Storage>{
     public:
         KagomeNetwork(int kagome_width, int kagome_height) {
             if (kagome_width < 0 || kagome_height < 0)
                 throw NetworkException("Width or height of kagome should be positive.");
 
             int w = kagome_width, h = kagome_height;
+            this->reserve(3 * w * h, 4);
             for (int i = 0; i < h; ++i) {
                 for (int j = 0; j < w; ++j) {
                     this->add_edge(3 * (i * w + j), 3 * (i * w + j) + 1);
@@ -399,6 +433,7 @@ class KagomeNetwork: public Network<int, _NData, _EData>{
                     this->add_edge(3 * (i * w + j) + 1, 3 * (((i * w + j) + w) % (h * w)) + 2);
                 }
             }
+            this->reserve(0);
 
             this->kagome_width = kagome_width;
             this->kagome_height = kagome_height;
@@ -409,20 +444,26 @@ class KagomeNetwork: public Network<int, _NData, _EData>{
 };
 
 
-template <class _NData=None, class _EData=None>
+template <class _NData=None, class _EData=None, class _Storage=HashStorage>
 class ScaleFreeNetwork;
-template <class _NData, class _EData>
-class ScaleFreeNetwork: public Network<int, _NData, _EData>{
+template <class _NData, class _EData, class _Storage>
+class ScaleFreeNetwork: public Network<int, _NData, _EData, _Storage>{
     public:
-        ScaleFreeNetwork(int n_nodes, int n_edges_per_node) {
+        ScaleFreeNetwork(int n_nodes, int n_edges_per_node)
+            : ScaleFreeNetwork(n_nodes, n_edges_per_node, default_engine()) {}
+
+        template <class _Rng>
+        ScaleFreeNetwork(int n_nodes, int n_edges_per_node, _Rng &rng) {
             if (n_nodes < 0)
                 throw NetworkException("Number of nodes should be positive.");
             if (n_edges_per_node < 0 || n_edges_per_node > n_nodes)
                 throw NetworkException("Increment of edges per node should be "
                         "positive and no more than number of nodes.");
 
-            for (int i = 0; i < n_nodes; ++i)
-                this->add_node(i);
+            /* Preferential attachment reads degrees while linking, so
+             * only nodes are added in bulk. */
+            std::vector<int> nodes = node_range(n_nodes);
+            this->add_nodes_from(nodes.begin(), nodes.end());
             int m = n_edges_per_node;
             int vn = this->number_of_nodes(), cur = m;
             int i, j, nv;           /* nv = degree(v) */
@@ -435,7 +476,7 @@ class ScaleFreeNetwork: public Network<int, _NData, _EData>{
                         if (this->has_edge(j, cur)) continue;
                         nv = this->degree(j);
                         t -= nv;
-                        if (randf() > nv/(t + nv)) continue;
+                        if (rng.randf() > nv/(t + nv)) continue;
                         this->add_edge(j, cur);
                         total -= nv;
                         break;
@@ -0,0 +1,303 @@
+/*
+ * This file contains code from https://github.com/hxt-tg/cimnet
+ * and is covered under the copyright and warranty notices:
+ * "Copyright (C) 2022 CimNet Developers
+ *  Xintao Hu <hxt.taoge@gmail.com>"
+ */
+
+/*
+ *  This file contains columnar node properties. Each property is a
+ *  named, typed column stored in a contiguous array indexed by a dense
+ *  node index (0 to n-1), kept alongside any network instead of inside
+ *  its node data. Scanning one small field of all nodes then touches
+ *  only that field.
+ *  For further usage, check out http://doc.hxtcloud.cn.
+ */
+
+#ifndef CIMNET_PROPERTY
+#define CIMNET_PROPERTY
+
+#include <unordered_map>
+#include <vector>
+#include <string>
+#include <memory>
+#include <algorithm>
+#include <type_traits>
+
+#include "_exception.h"
+
+
+/* Dense index of node ids. Nodes are numbered in the order they are
+ * indexed. */
+template <class _NId>
+class NodeIndex {
+    public:
+    NodeIndex () : _ids(), _index() {}
+
+    template <class _Net>
+    explicit NodeIndex (const _Net &net) : _ids(), _index() {
+        sync(net);
+    }
+
+    /* Index nodes of net that are not indexed yet. Indices of removed
+     * nodes are kept, see remove. Return the number of indexed nodes. */
+    template <class _Net>
+    inline int sync(const _Net &net) {
+        _ids.reserve(net.number_of_nodes());
+        _index.reserve(net.number_of_nodes());
+        for (const auto &id : net.iterate_nodes())
+            add(id);
+        return size();
+    }
+
+    /* Index a node and return its index. */
+    inline int add(const _NId &id) {
+        auto r = _index.emplace(id, size());
+        if (r.second) _ids.push_back(id);
+        return r.first->second;
+    }
+
+    /* Drop a node. The last indexed node takes its index, which is
+     * returned. */
+    inline int remove(const _NId &id) {
+        auto it = _index.find(id);
+        if (it == _index.end()) throw NoNodeException<_NId>(id);
+        int index = it->second;
+        _index.erase(it);
+        if (index != size() - 1) {
+            _ids[index] = std::move(_ids.back());
+            _index[_ids[index]] = index;
+        }
+        _ids.pop_back();
+        return index;
+    }
+
+    inline bool has(const _NId &id) const {
+        return _index.find(id) != _index.end();
+    }
+
+    inline int index_of(const _NId &id) const {
+        auto it = _index.find(id);
+        if (it == _index.end()) throw NoNodeException<_NId>(id);
+        return it->second;
+    }
+
+    inline const _NId &id_of(int index) const {
+        return _ids[index];
+    }
+
+    inline const std::vector<_NId> &ids() const {
+        return _ids;
+    }
+
+    inline int size() const {
+        return _ids.size();
+    }
+
+    private:
+    std::vector<_NId> _ids;
+    std::unordered_map<_NId, int> _index;
+};
+
+
+/* Accumulator type of NodeProperty::sum */
+template <class _T>
+struct _PropertySum {
+    typedef typename std::conditional<std::is_floating_point<_T>::value,
+            double, long long>::type type;
+};
+
+class _PropertyColumn {
+    public:
+    virtual ~_PropertyColumn () {}
+    virtual void resize(int n) = 0;
+    virtual void remove(int index) = 0;
+    virtual _PropertyColumn *clone() const = 0;
+};
+
+/* Column of one node property. Values are indexed by the dense node
+ * index of the owning NodeProperties. */
+template <class _T>
+class NodeProperty : public _PropertyColumn {
+    static_assert(!std::is_same<_T, bool>::value,
+            "std::vector<bool> is not contiguous, use char for flags.");
+
+    public:
+    explicit NodeProperty (int n=0, const _T &init=_T()) : _values(n, init), _init(init) {}
+
+    inline _T &operator[](int index) {
+        return _values[index];
+    }
+
+    inline const _T &operator[](int index) const {
+        return _values[index];
+    }
+
+    inline _T *data() {
+        return _values.data();
+    }
+
+    inline const _T *data() const {
+        return _values.data();
+    }
+
+    inline int size() const {
+        return _values.size();
+    }
+
+    inline void fill(const _T &value) {
+        std::fill(_values.begin(), _values.end(), value);
+    }
+
+    inline int count(const _T &value) const {
+        return std::count(_values.begin(), _values.end(), value);
+    }
+
+    template <class _Acc=typename _PropertySum<_T>::type>
+    inline _Acc sum() const {
+        _Acc s = _Acc();
+        const _T *v = _values.data();
+        for (int i = 0, n = size(); i < n; i++)
+            s += v[i];
+        return s;
+    }
+
+    /* Number of nodes holding each value in [0, n_bins). Values out of
+     * range are not counted. */
+    inline std::vector<int> histogram(int n_bins) const {
+        std::vector<int> h(n_bins, 0);
+        const _T *v = _values.data();
+        for (int i = 0, n = size(); i < n; i++) {
+            long long k = static_cast<long long>(v[i]);
+            if (k >= 0 && k < n_bins) ++h[k];
+        }
+        return h;
+    }
+
+    void resize(int n) override {
+        _values.resize(n, _init);
+    }
+
+    /* Move the last value into index. */
+    void remove(int index) override {
+        if (index != size() - 1) _values[index] = std::move(_values.back());
+        _values.pop_back();
+    }
+
+    _PropertyColumn *clone() const override {
+        return new NodeProperty(*this);
+    }
+
+    private:
+    std::vector<_T> _values;
+    _T _init;
+};
+
+
+/* Named node property columns sharing one node index */
+template <class _NId>
+class NodeProperties {
+    typedef std::unordered_map<std::string, std::unique_ptr<_PropertyColumn>> _ColumnsType;
+
+    public:
+    NodeProperties () : _index(), _columns() {}
+
+    template <class _Net>
+    explicit NodeProperties (const _Net &net) : _index(net), _columns() {}
+
+    NodeProperties (const NodeProperties &other) : _index(other._index), _columns() {
+        for (auto &c : other._columns)
+            _columns[c.first].reset(c.second->clone());
+    }
+
+    NodeProperties &operator=(const NodeProperties &other) {
+        if (this == &other) return *this;
+        NodeProperties copy(other);
+        std::swap(_index, copy._index);
+        std::swap(_columns, copy._columns);
+        return *this;
+    }
+
+    /* Drop the rows of nodes removed from net and index nodes added
+     * since the last sync. New nodes get the initial value of every
+     * property. Dropping moves rows as remove does, so counts and sums
+     * cover only nodes of net. */
+    template <class _Net>
+    inline int sync(const _Net &net) {
+        for (int i = size() - 1; i >= 0; i--)
+            if (!net.has_node(_index.id_of(i))) remove(_NId(_index.id_of(i)));
+        int n = _index.sync(net);
+        for (auto &c : _columns)
+            c.second->resize(n);
+        return n;
+    }
+
+    /* Drop the row of node id. The row of the last indexed node moves
+     * into it, changing that node's index. */
+    inline void remove(const _NId &id) {
+        int index = _index.index_of(id);
+        for (auto &c : _columns)
+            c.second->remove(index);
+        _index.remove(id);
+    }
+
+    template <class _T>
+    inline NodeProperty<_T> &add_property(const std::string &name, const _T &init=_T()) {
+        if (has_property(name))
+            throw NetworkException("Property \"" + name + "\" already exists.");
+        NodeProperty<_T> *column = new NodeProperty<_T>(size(), init);
+        _columns[name].reset(column);
+        return *column;
+    }
+
+    template <class _T>
+    inline NodeProperty<_T> &property(const std::string &name) {
+        return *_column<_T>(name);
+    }
+
+    template <class _T>
+    inline const NodeProperty<_T> &property(const std::string &name) const {
+        return *_column<_T>(name);
+    }
+
+    inline bool has_property(const std::string &name) const {
+        return _columns.find(name) != _columns.end();
+    }
+
+    inline void remove_property(const std::string &name) {
+        _columns.erase(name);
+    }
+
+    inline const NodeIndex<_NId> &index() const {
+        return _index;
+    }
+
+    inline int index_of(const _NId &id) const {
+        return _index.index_of(id);
+    }
+
+    inline const _NId &id_of(int index) const {
+        return _index.id_of(index);
+    }
+
+    inline int size() const {
+        return _index.size();
+    }
+
+    private:
+    template <class _T>
+    inline NodeProperty<_T> *_column(const std::string &name) const {
+        auto it = _columns.find(name);
+        if (it == _columns.end())
+            throw NetworkException("No property \"" + name + "\".");
+        NodeProperty<_T> *column = dynamic_cast<NodeProperty<_T> *>(it->second.get());
+        if (!column)
+            throw NetworkException("Property \"" + name + "\" has another type.");
+        return column;
+    }
+
+    NodeIndex<_NId> _index;
+    _ColumnsType _columns;
+};
+
+#endif /* ifndef CIMNET_PROPERTY */
@@ -7,80 +7,614 @@
  *   If there is any infringement, please contact via email:
  *   hxt.taoge@gmail.com)
  *
+ *  Each engine object keeps its own state, so threads drawing from
+ *  different engines do not interfere. The free functions sgenrand,
+ *  genrand, randf and randi draw from one shared default engine.
+ *  XoshiroEngine (xoshiro256**, by David Blackman & Sebastiano Vigna)
+ *  can jump ahead by 2^128 numbers, which splits it into independent
+ *  streams, one per thread. Xoshiro4Engine steps four such streams
+ *  at once with SSE2 or AVX2 when available. PhiloxEngine computes
+ *  the numbers of (seed, replica, node, step) from scratch, so results
+ *  do not depend on how work is spread over threads.
+ *
+ *  Arrays of numbers are filled by fill_randf and fill_randi faster than
+ *  by calling randf and randi in a loop. Xoshiro engines bound integers
+ *  by multiplying rather than dividing. Every engine saves and loads its
+ *  full state with save_state and load_state, see checkpoint.h.
+ *
+ *  Anything taking an engine (random_neighbor, generators in
+ *  network.h, ...) accepts any class with randi(LIM) and randf().
  *  For further usage, check out http://doc.hxtcloud.cn.
  */
 
 #ifndef CIMNET_RANDOM
 #define CIMNET_RANDOM
 
-void sgenrand(unsigned long seed);
-void lsgenrand(const unsigned long seed_array[]);
-double genrand();
-double randf();
-long randi(unsigned long LIM);
-
-
-/* Random - Implementation */
-#define NN 624
-#define MM 397
-#define MATRIX_A 0x9908b0df          /* constant vector a */
-#define UPPER_MASK 0x80000000        /* most significant w-r bits */
-#define LOWER_MASK 0x7fffffff        /* least significant r bits */
-#define TEMPERING_MASK_B 0x9d2c5680
-#define TEMPERING_MASK_C 0xefc60000
-#define NAMEOUT     "K4b075r5Q2"
-
-#define TEMPERING_SHIFT_U(y)  ((y) >> 11)
-#define TEMPERING_SHIFT_S(y)  ((y) << 7)
-#define TEMPERING_SHIFT_T(y)  ((y) << 15)
-#define TEMPERING_SHIFT_L(y)  ((y) >> 18)
-
-static unsigned long mt[NN];        /* the array for the state vector  */
-static int mti = NN + 1;            /* mti==NN+1 means mt[NN] is not initialized */
-
-void sgenrand(unsigned long seed){
-    int i;
-    for (i = 0; i < NN; i++) {
-        mt[i] = seed & 0xffff0000; seed = 69069 * seed + 1;
-        mt[i] |= (seed & 0xffff0000) >> 16; seed = 69069 * seed + 1;
-    }
-    mti = NN;
-}
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
 
-void lsgenrand(const unsigned long seed_array[]){
-    int i; for (i = 0; i < NN; i++) mt[i] = seed_array[i]; mti = NN;
-}
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+/* Mersenne twister engine */
+class MTEngine {
+    public:
+    explicit MTEngine (unsigned long seed=4357) {
+        sgenrand(seed);
+    }
+
+    void sgenrand(unsigned long seed) {
+        int i;
+        for (i = 0; i < NN; i++) {
+            mt[i] = seed & 0xffff0000; seed = 69069 * seed + 1;
+            mt[i] |= (seed & 0xffff0000) >> 16; seed = 69069 * seed + 1;
+        }
+        mti = NN;
+    }
 
-double genrand(){
-    unsigned long y;
-    static unsigned long mag01[2] = { 0x0, MATRIX_A };
-    if (mti >= NN)
-    {
+    void lsgenrand(const unsigned long seed_array[]) {
+        int i; for (i = 0; i < NN; i++) mt[i] = seed_array[i]; mti = NN;
+    }
+
+    /* Write the state and the position in it, so that an engine loading
+     * them goes on with the same numbers (see checkpoint.h). out is any
+     * stream with write(const char *, n). */
+    template <class _Out>
+    void save_state(_Out &out) const {
+        out.write((const char *)mt, sizeof mt);
+        out.write((const char *)&mti, sizeof mti);
+    }
+
+    /* Read a state written by save_state. Return false, leaving the
+     * engine unchanged, if in ends early or holds no such state. */
+    template <class _In>
+    bool load_state(_In &in) {
+        MTEngine e(*this);
+        if (!in.read((char *)e.mt, sizeof e.mt) || !in.read((char *)&e.mti, sizeof e.mti)
+                || e.mti < 0 || e.mti > NN)
+            return false;
+        *this = e;
+        return true;
+    }
+
+    double genrand() {
+        if (mti >= NN) _generate();
+        return _temper(mt[mti++]);
+    }
+
+    double randf() {
+        return ((double)genrand() * 2.3283064370807974e-10);
+    }
+
+    long randi(unsigned long LIM) {
+        return (long)((unsigned long)genrand() % LIM);
+    }
+
+    /* Same numbers as n calls of randf, checking the state once per
+     * block of NN numbers instead of once per number. */
+    void fill_randf(double *out, size_t n) {
+        while (n > 0) {
+            if (mti >= NN) _generate();
+            size_t k = n < (size_t)(NN - mti) ? n : NN - mti;
+            const unsigned long *src = mt + mti;
+            for (size_t i = 0; i < k; i++)
+                out[i] = (double)_temper(src[i]) * 2.3283064370807974e-10;
+            mti += k; out += k; n -= k;
+        }
+    }
+
+    /* Same numbers as n calls of randi(LIM). */
+    void fill_randi(long *out, size_t n, unsigned long LIM) {
+        while (n > 0) {
+            if (mti >= NN) _generate();
+            size_t k = n < (size_t)(NN - mti) ? n : NN - mti;
+            const unsigned long *src = mt + mti;
+            for (size_t i = 0; i < k; i++)
+                out[i] = (long)(_temper(src[i]) % LIM);
+            mti += k; out += k; n -= k;
+        }
+    }
+
+    private:
+    /* Next NN numbers of the state vector, without branches so that
+     * the loops vectorize. */
+    void _generate() {
+        unsigned long y;
         int kk;
-        if (mti == NN + 1) sgenrand(4357);
         for (kk = 0; kk < NN - MM; kk++) {
             y = (mt[kk] & UPPER_MASK) | (mt[kk + 1] & LOWER_MASK);
-            mt[kk] = mt[kk + MM] ^ (y >> 1) ^ mag01[y & 0x1];
+            mt[kk] = mt[kk + MM] ^ (y >> 1) ^ (-(y & 0x1) & MATRIX_A);
         }
         for (; kk < NN - 1; kk++) {
             y = (mt[kk] & UPPER_MASK) | (mt[kk + 1] & LOWER_MASK);
-            mt[kk] = mt[kk + (MM - NN)] ^ (y >> 1) ^ mag01[y & 0x1];
+            mt[kk] = mt[kk + (MM - NN)] ^ (y >> 1) ^ (-(y & 0x1) & MATRIX_A);
         }
         y = (mt[NN - 1] & UPPER_MASK) | (mt[0] & LOWER_MASK);
-        mt[NN - 1] = mt[MM - 1] ^ (y >> 1) ^ mag01[y & 0x1];
+        mt[NN - 1] = mt[MM - 1] ^ (y >> 1) ^ (-(y & 0x1) & MATRIX_A);
         mti = 0;
     }
-    y = mt[mti++]; y ^= TEMPERING_SHIFT_U(y); y ^= TEMPERING_SHIFT_S(y) & TEMPERING_MASK_B;
-    y ^= TEMPERING_SHIFT_T(y) & TEMPERING_MASK_C; y ^= TEMPERING_SHIFT_L(y);
-    return y;
+
+    static inline unsigned long _temper(unsigned long y) {
+        y ^= (y >> 11); y ^= (y << 7) & TEMPERING_MASK_B;
+        y ^= (y << 15) & TEMPERING_MASK_C; y ^= (y >> 18);
+        return y;
+    }
+
+    static const int NN = 624;
+    static const int MM = 397;
+    static const unsigned long MATRIX_A = 0x9908b0df;         /* constant vector a */
+    static const unsigned long UPPER_MASK = 0x80000000;       /* most significant w-r bits */
+    static const unsigned long LOWER_MASK = 0x7fffffff;       /* least significant r bits */
+    static const unsigned long TEMPERING_MASK_B = 0x9d2c5680;
+    static const unsigned long TEMPERING_MASK_C = 0xefc60000;
+
+    unsigned long mt[NN];       /* the array for the state vector  */
+    int mti;
+};
+
+
+/* Random integer in [0, LIM) from the high 32 bits of gen.next(), by
+ * multiplying instead of dividing (Lemire's method). A product whose low
+ * half is below 2^32 mod LIM is redrawn to avoid bias; the modulo giving
+ * that bound is computed only when the low half is below LIM, that is
+ * with probability LIM / 2^32. */
+template <class _Gen>
+inline long _bounded_rand(_Gen &gen, unsigned long LIM) {
+    if (LIM > 0xffffffffUL) return (long)(gen.next() % LIM);
+    uint32_t lim = (uint32_t)LIM;
+    uint64_t m = (gen.next() >> 32) * lim;
+    if ((uint32_t)m < lim) {
+        uint32_t t = (0U - lim) % lim;
+        while ((uint32_t)m < t)
+            m = (gen.next() >> 32) * lim;
+    }
+    return (long)(m >> 32);
+}
+
+
+/* xoshiro256** engine, with jump-ahead */
+class XoshiroEngine {
+    friend class Xoshiro4Engine;
+
+    public:
+    explicit XoshiroEngine (uint64_t s=4357) {
+        seed(s);
+    }
+
+    /* Fill the state from seed with splitmix64, as the authors advise. */
+    void seed(uint64_t s) {
+        for (int i = 0; i < 4; i++) {
+            uint64_t z = (s += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            _s[i] = z ^ (z >> 31);
+        }
+    }
+
+    uint64_t next() {
+        uint64_t result = _rotate(_s[1] * 5, 7) * 9;
+        uint64_t t = _s[1] << 17;
+        _s[2] ^= _s[0];
+        _s[3] ^= _s[1];
+        _s[1] ^= _s[2];
+        _s[0] ^= _s[3];
+        _s[2] ^= t;
+        _s[3] = _rotate(_s[3], 45);
+        return result;
+    }
+
+    /* Uniform in [0, 1), with 53 random bits. */
+    double randf() {
+        return (next() >> 11) * 1.1102230246251565e-16;
+    }
+
+    long randi(unsigned long LIM) {
+        return _bounded_rand(*this, LIM);
+    }
+
+    /* Advance by 2^128 numbers. */
+    void jump() {
+        static const uint64_t JUMP[4] = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+                                          0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+        _jump(JUMP);
+    }
+
+    /* Advance by 2^192 numbers. */
+    void long_jump() {
+        static const uint64_t LONG_JUMP[4] = { 0x76e15d3efefdcbbfULL, 0xc5004e441c522fb3ULL,
+                                               0x77710069854ee241ULL, 0x39109bb02acbe635ULL };
+        _jump(LONG_JUMP);
+    }
+
+    /* See MTEngine::save_state. */
+    template <class _Out>
+    void save_state(_Out &out) const {
+        out.write((const char *)_s, sizeof _s);
+    }
+
+    template <class _In>
+    bool load_state(_In &in) {
+        uint64_t s[4];
+        if (!in.read((char *)s, sizeof s)) return false;
+        std::memcpy(_s, s, sizeof s);
+        return true;
+    }
+
+    private:
+    static inline uint64_t _rotate(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    void _jump(const uint64_t poly[4]) {
+        uint64_t s[4] = { 0, 0, 0, 0 };
+        for (int i = 0; i < 4; i++)
+            for (int b = 0; b < 64; b++) {
+                if (poly[i] & (1ULL << b))
+                    for (int j = 0; j < 4; j++)
+                        s[j] ^= _s[j];
+                next();
+            }
+        for (int j = 0; j < 4; j++)
+            _s[j] = s[j];
+    }
+
+    uint64_t _s[4];
+};
+
+/* Four xoshiro256** engines (lanes), each 2^128 numbers after the
+ * previous one, stepped together so that the compiler vectorizes them.
+ * Numbers are taken from lane 0, 1, 2, 3, then lane 0 again, etc. The
+ * bulk fill functions give the same numbers as calling next, randf or
+ * randi n times. */
+class Xoshiro4Engine {
+    public:
+    static const int LANES = 4;
+
+    explicit Xoshiro4Engine (uint64_t s=4357) {
+        seed(s);
+    }
+
+    void seed(uint64_t s) {
+        XoshiroEngine e(s);
+        for (int l = 0; l < LANES; l++) {
+            for (int j = 0; j < 4; j++)
+                _s[j][l] = e._s[j];
+            e.jump();
+        }
+        _pos = BUFFER;
+    }
+
+    uint64_t next() {
+        if (_pos == BUFFER) {
+            _steps(_buf, BUFFER / LANES);
+            _pos = 0;
+        }
+        return _buf[_pos++];
+    }
+
+    /* Uniform in [0, 1), with 52 random bits. */
+    double randf() {
+        return _to_unit(next());
+    }
+
+    long randi(unsigned long LIM) {
+        return _bounded_rand(*this, LIM);
+    }
+
+    void fill(uint64_t *out, size_t n) {
+        for (; n > 0 && _pos < BUFFER; n--)
+            *out++ = _buf[_pos++];
+        size_t steps = n / LANES;
+        _steps(out, steps);
+        out += steps * LANES;
+        for (n -= steps * LANES; n > 0; n--)
+            *out++ = next();
+    }
+
+    void fill_randf(double *out, size_t n) {
+        uint64_t words[BUFFER];
+        while (n > 0) {
+            size_t k = n < BUFFER ? n : BUFFER;
+            fill(words, k);
+            for (size_t i = 0; i < k; i++)
+                out[i] = _to_unit(words[i]);
+            out += k; n -= k;
+        }
+    }
+
+    void fill_randi(long *out, size_t n, unsigned long LIM) {
+        if (LIM > 0xffffffffUL) {
+            for (size_t i = 0; i < n; i++)
+                out[i] = randi(LIM);
+            return;
+        }
+        uint32_t lim = (uint32_t)LIM;
+        uint32_t t = (0U - lim) % lim;      /* once per call, see _bounded_rand */
+        uint64_t words[BUFFER];
+        while (n > 0) {
+            /* Draw only as many words as numbers still needed, so that
+             * no word is skipped. */
+            size_t k = n < BUFFER ? n : BUFFER, drawn = k;
+            fill(words, drawn);
+            /* Map every word without branches, tracking the smallest
+             * low half to find out whether any must be rejected. */
+            uint64_t low = ~0ULL;
+            for (size_t i = 0; i < k; i++) {
+                uint64_t m = (uint64_t)(uint32_t)(words[i] >> 32) * lim;
+                out[i] = (long)(m >> 32);
+                low = low < (m & 0xffffffffULL) ? low : (m & 0xffffffffULL);
+            }
+            if (low < t) {
+                /* Rarely: keep only the accepted numbers. */
+                k = 0;
+                for (size_t i = 0; i < drawn; i++) {
+                    uint64_t m = (words[i] >> 32) * lim;
+                    if ((uint32_t)m >= t) out[k++] = (long)(m >> 32);
+                }
+            }
+            out += k; n -= k;
+        }
+    }
+
+    /* Advance every lane by 2^192 numbers, so that engines seeded alike
+     * and long-jumped different times do not overlap. */
+    void long_jump() {
+        for (int l = 0; l < LANES; l++) {
+            XoshiroEngine e;
+            for (int j = 0; j < 4; j++)
+                e._s[j] = _s[j][l];
+            e.long_jump();
+            for (int j = 0; j < 4; j++)
+                _s[j][l] = e._s[j];
+        }
+        _pos = BUFFER;
+    }
+
+    /* See MTEngine::save_state. Numbers drawn into the buffer but not
+     * taken yet are part of the state. */
+    template <class _Out>
+    void save_state(_Out &out) const {
+        out.write((const char *)_s, sizeof _s);
+        out.write((const char *)_buf, sizeof _buf);
+        out.write((const char *)&_pos, sizeof _pos);
+    }
+
+    template <class _In>
+    bool load_state(_In &in) {
+        Xoshiro4Engine e(*this);
+        if (!in.read((char *)e._s, sizeof e._s) || !in.read((char *)e._buf, sizeof e._buf)
+                || !in.read((char *)&e._pos, sizeof e._pos) || e._pos > BUFFER)
+            return false;
+        *this = e;
+        return true;
+    }
+
+    private:
+    static const size_t BUFFER = 64;
+
+    static inline uint64_t _rotate(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    /* Exponent of 1.0 with 52 random bits of mantissa, minus 1. */
+    static inline double _to_unit(uint64_t x) {
+        uint64_t bits = (x >> 12) | 0x3ff0000000000000ULL;
+        double d;
+        std::memcpy(&d, &bits, sizeof(d));
+        return d - 1.0;
+    }
+
+    /* Write steps * LANES numbers to out. */
+    void _steps(uint64_t *out, size_t steps) {
+#if defined(__AVX2__)
+        /* All four lanes in one register; x * 5 and x * 9 as shifts and
+         * adds, since AVX2 has no 64-bit multiply. */
+        __m256i s0 = _mm256_loadu_si256((const __m256i *)_s[0]);
+        __m256i s1 = _mm256_loadu_si256((const __m256i *)_s[1]);
+        __m256i s2 = _mm256_loadu_si256((const __m256i *)_s[2]);
+        __m256i s3 = _mm256_loadu_si256((const __m256i *)_s[3]);
+        for (size_t i = 0; i < steps; i++, out += LANES) {
+            __m256i x = _mm256_add_epi64(_mm256_slli_epi64(s1, 2), s1);
+            x = _mm256_or_si256(_mm256_slli_epi64(x, 7), _mm256_srli_epi64(x, 57));
+            x = _mm256_add_epi64(_mm256_slli_epi64(x, 3), x);
+            _mm256_storeu_si256((__m256i *)out, x);
+            __m256i t = _mm256_slli_epi64(s1, 17);
+            s2 = _mm256_xor_si256(s2, s0);
+            s3 = _mm256_xor_si256(s3, s1);
+            s1 = _mm256_xor_si256(s1, s2);
+            s0 = _mm256_xor_si256(s0, s3);
+            s2 = _mm256_xor_si256(s2, t);
+            s3 = _mm256_or_si256(_mm256_slli_epi64(s3, 45), _mm256_srli_epi64(s3, 19));
+        }
+        _mm256_storeu_si256((__m256i *)_s[0], s0);
+        _mm256_storeu_si256((__m256i *)_s[1], s1);
+        _mm256_storeu_si256((__m256i *)_s[2], s2);
+        _mm256_storeu_si256((__m256i *)_s[3], s3);
+#elif defined(__SSE2__)
+        /* Two lanes per register */
+        __m128i s0[2], s1[2], s2[2], s3[2];
+        for (int h = 0; h < 2; h++) {
+            s0[h] = _mm_loadu_si128((const __m128i *)&_s[0][2 * h]);
+            s1[h] = _mm_loadu_si128((const __m128i *)&_s[1][2 * h]);
+            s2[h] = _mm_loadu_si128((const __m128i *)&_s[2][2 * h]);
+            s3[h] = _mm_loadu_si128((const __m128i *)&_s[3][2 * h]);
+        }
+        for (size_t i = 0; i < steps; i++, out += LANES)
+            for (int h = 0; h < 2; h++) {
+                __m128i x = _mm_add_epi64(_mm_slli_epi64(s1[h], 2), s1[h]);
+                x = _mm_or_si128(_mm_slli_epi64(x, 7), _mm_srli_epi64(x, 57));
+                x = _mm_add_epi64(_mm_slli_epi64(x, 3), x);
+                _mm_storeu_si128((__m128i *)(out + 2 * h), x);
+                __m128i t = _mm_slli_epi64(s1[h], 17);
+                s2[h] = _mm_xor_si128(s2[h], s0[h]);
+                s3[h] = _mm_xor_si128(s3[h], s1[h]);
+                s1[h] = _mm_xor_si128(s1[h], s2[h]);
+                s0[h] = _mm_xor_si128(s0[h], s3[h]);
+                s2[h] = _mm_xor_si128(s2[h], t);
+                s3[h] = _mm_or_si128(_mm_slli_epi64(s3[h], 45), _mm_srli_epi64(s3[h], 19));
+            }
+        for (int h = 0; h < 2; h++) {
+            _mm_storeu_si128((__m128i *)&_s[0][2 * h], s0[h]);
+            _mm_storeu_si128((__m128i *)&_s[1][2 * h], s1[h]);
+            _mm_storeu_si128((__m128i *)&_s[2][2 * h], s2[h]);
+            _mm_storeu_si128((__m128i *)&_s[3][2 * h], s3[h]);
+        }
+#else
+        for (size_t i = 0; i < steps; i++, out += LANES)
+            for (int l = 0; l < LANES; l++) {
+                out[l] = _rotate(_s[1][l] * 5, 7) * 9;
+                uint64_t t = _s[1][l] << 17;
+                _s[2][l] ^= _s[0][l];
+                _s[3][l] ^= _s[1][l];
+                _s[1][l] ^= _s[2][l];
+                _s[0][l] ^= _s[3][l];
+                _s[2][l] ^= t;
+                _s[3][l] = _rotate(_s[3][l], 45);
+            }
+#endif
+    }
+
+    uint64_t _s[4][LANES];
+    uint64_t _buf[BUFFER];
+    size_t _pos;
+};
+
+
+/* n engines seeded by seed, each 2^128 numbers after the previous one,
+ * so that streams never overlap. */
+inline std::vector<XoshiroEngine> random_streams(int n, uint64_t seed=4357) {
+    std::vector<XoshiroEngine> streams;
+    streams.reserve(n);
+    XoshiroEngine engine(seed);
+    for (int i = 0; i < n; i++) {
+        streams.push_back(engine);
+        engine.jump();
+    }
+    return streams;
+}
+
+
+/* Philox4x32-10 (Salmon et al., Random123): four random words that
+ * depend only on the 128-bit counter ctr and the 64-bit key, so any
+ * thread can compute the numbers of any counter on its own. */
+inline void philox4x32(const uint32_t ctr[4], uint64_t key, uint32_t out[4]) {
+    uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+    uint32_t k0 = (uint32_t)key, k1 = (uint32_t)(key >> 32);
+    for (int r = 0; r < 10; r++) {
+        if (r > 0) {
+            k0 += 0x9e3779b9U;
+            k1 += 0xbb67ae85U;
+        }
+        uint64_t p0 = (uint64_t)0xd2511f53U * c0;
+        uint64_t p1 = (uint64_t)0xcd9e8d57U * c2;
+        c0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+        c2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+        c1 = (uint32_t)p1;
+        c3 = (uint32_t)p0;
+    }
+    out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+}
+
+/* Counter-based engine drawing the numbers of (seed, replica, node,
+ * step). Engines made with the same arguments give the same numbers,
+ * whichever thread makes them and in whatever order, so results do
+ * not depend on the number of threads. */
+class PhiloxEngine {
+    public:
+    explicit PhiloxEngine (uint64_t seed, uint32_t replica=0, uint32_t node=0, uint32_t step=0)
+            : _key(seed), _pos(4) {
+        _ctr[0] = 0;
+        _ctr[1] = step;
+        _ctr[2] = node;
+        _ctr[3] = replica;
+    }
+
+    uint64_t next() {
+        if (_pos == 4) {
+            philox4x32(_ctr, _key, _words);
+            _ctr[0]++;
+            _pos = 0;
+        }
+        uint64_t x = (uint64_t)_words[_pos] << 32 | _words[_pos + 1];
+        _pos += 2;
+        return x;
+    }
+
+    /* Uniform in [0, 1), with 53 random bits. */
+    double randf() {
+        return (next() >> 11) * 1.1102230246251565e-16;
+    }
+
+    long randi(unsigned long LIM) {
+        return _bounded_rand(*this, LIM);
+    }
+
+    /* See MTEngine::save_state. */
+    template <class _Out>
+    void save_state(_Out &out) const {
+        out.write((const char *)&_key, sizeof _key);
+        out.write((const char *)_ctr, sizeof _ctr);
+        out.write((const char *)_words, sizeof _words);
+        out.write((const char *)&_pos, sizeof _pos);
+    }
+
+    template <class _In>
+    bool load_state(_In &in) {
+        PhiloxEngine e(*this);
+        if (!in.read((char *)&e._key, sizeof e._key) || !in.read((char *)e._ctr, sizeof e._ctr)
+                || !in.read((char *)e._words, sizeof e._words) || !in.read((char *)&e._pos, sizeof e._pos)
+                || e._pos < 0 || e._pos > 4 || e._pos % 2 != 0)
+            return false;
+        *this = e;
+        return true;
+    }
+
+    private:
+    uint64_t _key;
+    uint32_t _ctr[4];      /* draw, step, node, replica */
+    uint32_t _words[4];
+    int _pos;
+};
+
+
+/* Default engine, shared by the free functions */
+inline MTEngine &default_engine() {
+    static MTEngine engine;
+    return engine;
+}
+
+inline void sgenrand(unsigned long seed) {
+    default_engine().sgenrand(seed);
+}
+
+inline void lsgenrand(const unsigned long seed_array[]) {
+    default_engine().lsgenrand(seed_array);
+}
+
+inline double genrand() {
+    return default_engine().genrand();
+}
+
+inline double randf() {
+    return default_engine().randf();
+}
+
+inline long randi(unsigned long LIM) {
+    return default_engine().randi(LIM);
 }
 
-double randf(){
-    return ((double)genrand() * 2.3283064370807974e-10);
+inline void fill_randf(double *out, size_t n) {
+    default_engine().fill_randf(out, n);
 }
 
-long randi(unsigned long LIM){
-    return (long)((unsigned long)genrand() % LIM);
+inline void fill_randi(long *out, size_t n, unsigned long LIM) {
+    default_engine().fill_randi(out, n, LIM);
 }
 
 #endif
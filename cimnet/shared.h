@@ -0,0 +1,295 @@
+/*
+ * This file contains code from https://github.com/hxt-tg/cimnet
+ * and is covered under the copyright and warranty notices:
+ * "Copyright (C) 2022 CimNet Developers
+ *  Xintao Hu <hxt.taoge@gmail.com>"
+ */
+
+/*
+ *  This file contains networks sharing their topology. Copying a
+ *  SharedNetwork copies only its node data, while the nodes, edges and
+ *  edge data stay shared with the copies. The first change of the
+ *  topology (adding or removing nodes and edges, or writing edge data)
+ *  gives the changed network a private copy (copy-on-write). An
+ *  ensemble of replicas of one large network, each with its own node
+ *  states, thus costs one topology plus one node map per replica.
+ *
+ *  Replicas may be used by different threads, but a single replica
+ *  should not be copied and changed at the same time.
+ *  For further usage, check out http://doc.hxtcloud.cn.
+ */
+
+#ifndef CIMNET_SHARED
+#define CIMNET_SHARED
+
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "_base_net.h"
+
+
+/* Shared topology and own node data, common to both kinds of shared
+ * networks */
+template <class _Net, class _NId, class _NData, class _EData, class _Storage>
+class _SharedBase {
+    typedef typename _Storage::template NodeMap<_NId, _NData> _NType;
+
+    public:
+    explicit _SharedBase (const _Net &net)
+        : _topo(std::make_shared<_Net>(net)), _data(net._nodes) {}
+    explicit _SharedBase (_Net &&net)
+        : _topo(std::make_shared<_Net>(std::move(net))), _data(_topo->_nodes) {}
+
+    /* Whether the topology is shared with other copies. */
+    inline bool is_shared() const {
+        return _topo.use_count() > 1;
+    }
+
+    /* The shared network. Its node data are those of the network the
+     * topology was taken from, not of this copy. */
+    inline const _Net &topology() const {
+        return *_topo;
+    }
+
+    inline _NId add_node(const _NId &id, const _NData &node_data=_NData()) {
+        if (!has_node(id)) _own().add_node(id);
+        _data[id] = node_data;
+        return id;
+    }
+
+    inline void add_edge(const _NId &id1, const _NId &id2, const _EData &edge_data=_EData()) {
+        _own().add_edge(id1, id2, edge_data);
+        if (_data.find(id1) == _data.end()) _data[id1] = _NData();
+        if (_data.find(id2) == _data.end()) _data[id2] = _NData();
+    }
+
+    inline void remove_edge(const _NId &id1, const _NId &id2) {
+        _check_edge(id1, id2);
+        _own().remove_edge(id1, id2);
+    }
+
+    inline void remove_node(const _NId &id) {
+        if (!has_node(id)) throw NoNodeException<_NId>(id);
+        _own().remove_node(id);
+        _data.erase(id);
+    }
+
+    inline bool has_node(const _NId &id) const {
+        return _data.find(id) != _data.end();
+    }
+
+    inline bool has_edge(const _NId &id1, const _NId &id2) const {
+        return _topo->has_edge(id1, id2);
+    }
+
+    inline _NData &node(const _NId &id) {
+        auto it = _data.find(id);
+        if (it == _data.end()) throw NoNodeException<_NId>(id);
+        return it->second;
+    }
+
+    inline _NData get_node_data(const _NId &id) const {
+        auto it = _data.find(id);
+        if (it == _data.end()) throw NoNodeException<_NId>(id);
+        return it->second;
+    }
+
+    /* Writable edge data, copying the topology if it is shared. Use
+     * get_edge_data to only read. */
+    inline _EData &edge(const _NId &id1, const _NId &id2) {
+        if (is_shared()) _topo->get_edge_data(id1, id2);   /* throw before copying */
+        return _own().edge(id1, id2);
+    }
+
+    inline _EData get_edge_data(const _NId &id1, const _NId &id2) const {
+        return _topo->get_edge_data(id1, id2);
+    }
+
+    inline int number_of_nodes() const {
+        return _topo->number_of_nodes();
+    }
+
+    inline int number_of_edges() const {
+        return _topo->number_of_edges();
+    }
+
+    inline int total_degree() const {
+        return _topo->total_degree();
+    }
+
+    inline int degree(const _NId &id) const {
+        return _topo->degree(id);
+    }
+
+    inline std::vector<_NId> nodes() const {
+        return _topo->nodes();
+    }
+
+    template <class _Rng=MTEngine>
+    inline std::pair<_NId, _NId> random_edge(_Rng &rng=default_engine()) const {
+        return _topo->random_edge(rng);
+    }
+
+    inline decltype(std::declval<const _Net &>().edges()) edges() const {
+        return _topo->edges();
+    }
+
+    inline decltype(std::declval<const _Net &>().iterate_edges()) iterate_edges() const {
+        return _topo->iterate_edges();
+    }
+
+    inline _NData &operator[](const _NId &id) {
+        return node(id);
+    }
+
+    inline _EData &operator()(const _NId &id1, const _NId &id2) {
+        return edge(id1, id2);
+    }
+
+    protected:
+    /* Throw as remove_edge would, before the topology is copied. */
+    inline void _check_edge(const _NId &id1, const _NId &id2) const {
+        if (!has_node(id1)) throw NoNodeException<_NId>(id1);
+        if (!has_node(id2)) throw NoNodeException<_NId>(id2);
+        if (!has_edge(id1, id2))
+            throw NoEdgeException<_NId>(id1, id2,
+                    std::is_same<_Net, DirectedNetwork<_NId, _NData, _EData, _Storage>>::value);
+    }
+
+    /* The topology, copied first if it is shared. A topology no longer
+     * shared may just have been released by a copy on another thread;
+     * the fence orders our writes after its reads. */
+    inline _Net &_own() {
+        if (is_shared()) _topo = std::make_shared<_Net>(*_topo);
+        else std::atomic_thread_fence(std::memory_order_acquire);
+        return *_topo;
+    }
+
+    std::shared_ptr<_Net> _topo;
+    _NType _data;
+};
+
+
+/* Undirected network sharing its topology with its copies */
+template <class _NId=Id, class _NData=None, class _EData=None, class _Storage=HashStorage>
+class SharedNetwork : public _SharedBase<Network<_NId, _NData, _EData, _Storage>,
+                                         _NId, _NData, _EData, _Storage> {
+    typedef Network<_NId, _NData, _EData, _Storage> _NetType;
+    typedef _SharedBase<_NetType, _NId, _NData, _EData, _Storage> _Base;
+
+    friend std::ostream& operator<<(std::ostream& out, const SharedNetwork& net) {
+        out << "Shared network {#(node)=" << net.number_of_nodes()
+            << ", #(edge)=" << net.number_of_edges()
+            << ", #(degree)=" << net.total_degree() << "}";
+        return out;
+    }
+
+    public:
+    SharedNetwork () : _Base(_NetType()) {}
+    explicit SharedNetwork (const _NetType &net) : _Base(net) {}
+    explicit SharedNetwork (_NetType &&net) : _Base(std::move(net)) {}
+
+    inline std::vector<_NId> neighbors(const _NId &id) const {
+        return this->_topo->neighbors(id);
+    }
+
+    inline NeighborView<_NId, _NData, _EData, _Storage> iterate_neighbors(const _NId &id) const {
+        return this->_topo->iterate_neighbors(id);
+    }
+
+    template <class _Rng=MTEngine>
+    inline _NId random_neighbor(const _NId &id, _Rng &rng=default_engine()) const {
+        return this->_topo->random_neighbor(id, rng);
+    }
+
+    template <class _Rng=MTEngine>
+    inline _NId weighted_random_neighbor(const _NId &id, _Rng &rng=default_engine()) const {
+        return this->_topo->weighted_random_neighbor(id, rng);
+    }
+
+    inline std::vector<_NId> common_neighbors(const _NId &id1, const _NId &id2) const {
+        return this->_topo->common_neighbors(id1, id2);
+    }
+
+    inline int count_common_neighbors(const _NId &id1, const _NId &id2) const {
+        return this->_topo->count_common_neighbors(id1, id2);
+    }
+};
+
+
+/* Directed network sharing its topology with its copies */
+template <class _NId=Id, class _NData=None, class _EData=None, class _Storage=HashStorage>
+class SharedDirectedNetwork : public _SharedBase<DirectedNetwork<_NId, _NData, _EData, _Storage>,
+                                                 _NId, _NData, _EData, _Storage> {
+    typedef DirectedNetwork<_NId, _NData, _EData, _Storage> _DiNetType;
+    typedef _SharedBase<_DiNetType, _NId, _NData, _EData, _Storage> _Base;
+
+    friend std::ostream& operator<<(std::ostream& out, const SharedDirectedNetwork& net) {
+        out << "Shared directed network {#(node)=" << net.number_of_nodes()
+            << ", #(edge)=" << net.number_of_edges()
+            << ", #(degree)=" << net.total_degree() << "}";
+        return out;
+    }
+
+    public:
+    SharedDirectedNetwork () : _Base(_DiNetType()) {}
+    explicit SharedDirectedNetwork (const _DiNetType &net) : _Base(net) {}
+    explicit SharedDirectedNetwork (_DiNetType &&net) : _Base(std::move(net)) {}
+
+    inline bool has_successor(const _NId &id1, const _NId &id2) const {
+        return this->_topo->has_successor(id1, id2);
+    }
+
+    inline bool has_predecessor(const _NId &id1, const _NId &id2) const {
+        return this->_topo->has_predecessor(id1, id2);
+    }
+
+    inline int out_degree(const _NId &id) const {
+        return this->_topo->out_degree(id);
+    }
+
+    inline int in_degree(const _NId &id) const {
+        return this->_topo->in_degree(id);
+    }
+
+    inline std::vector<_NId> successors(const _NId &id) const {
+        return this->_topo->successors(id);
+    }
+
+    inline std::vector<_NId> predecessors(const _NId &id) const {
+        return this->_topo->predecessors(id);
+    }
+
+    inline NeighborView<_NId, _NData, _EData, _Storage> iterate_successors(const _NId &id) const {
+        return this->_topo->iterate_successors(id);
+    }
+
+    inline NeighborView<_NId, _NData, _EData, _Storage> iterate_predecessors(const _NId &id) const {
+        return this->_topo->iterate_predecessors(id);
+    }
+
+    template <class _Rng=MTEngine>
+    inline _NId random_successor(const _NId &id, _Rng &rng=default_engine()) const {
+        return this->_topo->random_successor(id, rng);
+    }
+
+    template <class _Rng=MTEngine>
+    inline _NId random_predecessor(const _NId &id, _Rng &rng=default_engine()) const {
+        return this->_topo->random_predecessor(id, rng);
+    }
+
+    template <class _Rng=MTEngine>
+    inline _NId weighted_random_successor(const _NId &id, _Rng &rng=default_engine()) const {
+        return this->_topo->weighted_random_successor(id, rng);
+    }
+
+    template <class _Rng=MTEngine>
+    inline _NId weighted_random_predecessor(const _NId &id, _Rng &rng=default_engine()) const {
+        return this->_topo->weighted_random_predecessor(id, rng);
+    }
+};
+
+#endif /* ifndef CIMNET_SHARED */
@@ -0,0 +1,147 @@
+/*
+ * This file contains code from https://github.com/hxt-tg/cimnet
+ * and is covered under the copyright and warranty notices:
+ * "Copyright (C) 2022 CimNet Developers
+ *  Xintao Hu <hxt.taoge@gmail.com>"
+ */
+
+/*
+ *  This file contains versioned networks, letting threads read a
+ *  network while another thread changes it, without locks.
+ *
+ *  One writer thread changes the working network returned by writer(),
+ *  and calls publish() whenever it is in a consistent state. publish()
+ *  copies the working network into a new immutable version and makes
+ *  it current. Any number of reader threads call pin() to get the
+ *  current version as a Snapshot, and read it while the writer goes on.
+ *  A version is freed once it is neither current nor pinned by any
+ *  snapshot; the last freed version is kept to be overwritten by the
+ *  next publish(), which then reuses its memory.
+ *
+ *  publish() copies the working network on the writer thread, which
+ *  for Network and DirectedNetwork takes O(n + m) each time. With
+ *  SharedNetwork or SharedDirectedNetwork the versions share the
+ *  topology with the working network: publishing copies only the node
+ *  data, and the writer copies the topology once, at its first change
+ *  of nodes, edges or edge data after a publish. Runs that mostly
+ *  change node states should version a shared network.
+ *
+ *  Only the writer thread may call writer() and publish().
+ *  For further usage, check out http://doc.hxtcloud.cn.
+ */
+
+#ifndef CIMNET_SNAPSHOT
+#define CIMNET_SNAPSHOT
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+#include "_base_net.h"
+
+
+/* Network of a given version */
+template <class _Net>
+struct _NetworkVersion {
+    explicit _NetworkVersion(const _Net &n) : net(n), version(0) {}
+
+    _Net net;
+    unsigned long version;
+};
+
+
+/* Version of a network pinned by a reader. The version stays alive
+ * while any copy of the snapshot exists. */
+template <class _Net>
+class Snapshot {
+    template <class> friend class VersionedNetwork;
+
+    public:
+    Snapshot () : _ver() {}
+
+    inline unsigned long version() const {
+        return _ver->version;
+    }
+
+    inline const _Net &operator*() const {
+        return _ver->net;
+    }
+
+    inline const _Net *operator->() const {
+        return &_ver->net;
+    }
+
+    /* Unpin the version. */
+    inline void reset() {
+        _ver.reset();
+    }
+
+    inline explicit operator bool() const {
+        return (bool)_ver;
+    }
+
+    private:
+    explicit Snapshot (std::shared_ptr<const _NetworkVersion<_Net>> ver) : _ver(std::move(ver)) {}
+
+    std::shared_ptr<const _NetworkVersion<_Net>> _ver;
+};
+
+
+/* Network changed by one writer and read through snapshots */
+template <class _Net>
+class VersionedNetwork {
+    typedef _NetworkVersion<_Net> _VersionType;
+
+    public:
+    /* Start from net, published as version 1. */
+    explicit VersionedNetwork (_Net net=_Net())
+        : _net(std::move(net)), _current(), _spare(), _version(0) {
+        publish();
+    }
+
+    VersionedNetwork (const VersionedNetwork &) = delete;
+    VersionedNetwork &operator=(const VersionedNetwork &) = delete;
+
+    /* Working network, for the writer thread only. Changes are seen by
+     * readers after the next publish(). */
+    inline _Net &writer() {
+        return _net;
+    }
+
+    /* Make the working network the current version, and return its
+     * number. Costs a copy of the network (see above), made by the
+     * writer thread; readers are never blocked. */
+    inline unsigned long publish() {
+        std::shared_ptr<_VersionType> next;
+        if (_spare && _spare.use_count() == 1) {
+            /* Not current, so no reader can pin it any more. The fence
+             * orders our writes after the reads of its last reader. */
+            std::atomic_thread_fence(std::memory_order_acquire);
+            next = std::move(_spare);
+            next->net = _net;
+        } else {
+            next = std::make_shared<_VersionType>(_net);
+        }
+        next->version = ++_version;
+        _spare = std::atomic_exchange(&_current, next);
+        return _version;
+    }
+
+    /* Current version, for any thread. */
+    inline Snapshot<_Net> pin() const {
+        return Snapshot<_Net>(std::atomic_load(&_current));
+    }
+
+    /* Number of the current version, for any thread. */
+    inline unsigned long version() const {
+        return std::atomic_load(&_current)->version;
+    }
+
+    private:
+    _Net _net;
+    std::shared_ptr<_VersionType> _current;
+    std::shared_ptr<_VersionType> _spare;   /* previous version, reused if unpinned */
+    unsigned long _version;
+};
+
+#endif /* ifndef CIMNET_SNAPSHOT */
@@ -1,6 +1,6 @@
 #include <iostream>
 #include <vector>
-#include "cimnet/_base_net.h"
+#include "cimnet/interned.h"
 
 /* Define types */
 typedef std::string IpAddr;
@@ -80,7 +80,7 @@ class Internet {
         }
 
     private:
-        DirectedNetwork<IpAddr, HostData, PageViewAmount> net;
+        InternedDirectedNetwork<IpAddr, HostData, PageViewAmount> net;
 };
 
 
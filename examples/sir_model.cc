@@ -1,6 +1,7 @@
 #include <iostream>
 #include <vector>
 #include "cimnet/network.h"
+#include "cimnet/shared.h"
 #include "cimnet/random.h"
 
 typedef enum {
@@ -14,9 +15,11 @@ typedef struct {
 } NodeData;
 
 class SIRSimulation {
-    typedef Network<int, NodeData, None> SIRNetwork;
     public:
-    SIRSimulation(SIRNetwork &n, double beta, double gamma,
+    /* Replicas share the topology and only copy node data. */
+    typedef SharedNetwork<int, NodeData, None> SIRNetwork;
+
+    SIRSimulation(const SIRNetwork &n, double beta, double gamma,
             double init_I_rate=0.01)
         : _step(0), _beta(beta), _gamma(gamma), net(n) {
         std::vector<int> nodes = net.nodes();
@@ -75,7 +78,7 @@ class SIRSimulation {
 };
 
 int main(void) {
-    FullConnectedNetwork<NodeData, None> net(100);
+    SIRSimulation::SIRNetwork net(FullConnectedNetwork<NodeData, None>(100));
     SIRSimulation sir(net, 0.1, 0.08);
     for (int i = 0; i < 100; i++) {
         sir.step();
@@ -171,6 +171,117 @@ void test_random_neighbor() {
     std::cout << std::endl;
 }
 
+void test_random_edge() {
+    Network<int> n;
+    for (auto i = 1; i <= 30; i++)
+        n.add_edge(0, i);
+    for (auto i = 1; i <= 30; i += 2)
+        n.remove_edge(0, i);
+    std::cout << "Node 0's random neighbors:";
+    for (auto i = 0; i < 10; i++)
+        std::cout << " " << n.random_neighbor(0);
+    std::cout << std::endl << "Random edges:";
+    for (auto i = 0; i < 5; i++) {
+        auto e = n.random_edge();
+        std::cout << " [" << e.first << "-" << e.second << "]";
+    }
+    std::cout << std::endl;
+}
+
+void test_clear() {
+    Network<int, None, std::string> n;
+    n.add_edge(1, 2, "1-2");
+    n.add_edge(2, 3, "2-3");
+    n.clear();
+    std::cout << "After clear: " << n << std::endl;
+    n.add_edge(3, 4, "3-4");
+    std::cout << "Reused: " << n << " data=" << n(3, 4) << std::endl;
+}
+
+void test_iterate_edges() {
+    Network<int, None, std::string> n;
+    n.add_edge(2, 1, "2-1");
+    n.add_edge(2, 3, "2-3");
+    n.add_edge(3, 3, "3-3");
+    for (auto e : n.iterate_edges())
+        std::cout << "[" << e.first << "-" << e.second << "] data="
+                  << n(e.first, e.second) << std::endl;
+    DirectedNetwork<int, None, std::string> dn(n);
+    for (auto e : dn.iterate_edges())
+        std::cout << "[" << e.first << "->" << e.second << "] data="
+                  << dn(e.first, e.second) << std::endl;
+}
+
+void test_directed_neighbors() {
+    DirectedNetwork<int> dn;
+    dn.add_edge(1, 2);
+    dn.add_edge(2, 1);
+    dn.add_edge(1, 3);
+    dn.add_edge(4, 1);
+    dn.enable_reciprocal_index();
+    dn.add_edge(1, 4);
+    std::cout << "Neighbors of 1:";
+    for (auto n : dn.iterate_neighbors(1))
+        std::cout << " " << n;
+    std::cout << std::endl << "Mutual neighbors of 1:";
+    for (auto n : dn.mutual_neighbors(1))
+        std::cout << " " << n;
+    std::cout << std::endl;
+}
+
+void test_stats() {
+    GridNetwork<> grid(100, 100);
+    std::cout << grid.stats() << std::endl;
+    GridNetwork<None, None, DenseStorage> dense(100, 100);
+    std::cout << "Memory usage: hash " << grid.memory_usage()
+              << " bytes, dense " << dense.memory_usage() << " bytes" << std::endl;
+    Network<std::string, None, double> tiny;
+    tiny.add_edge("a", "b", 1.0);
+    Network<std::string, None, double> copy(tiny);
+    std::cout << "One-edge network and its copy under 4 KB: "
+              << (tiny.memory_usage() < 4096 && copy.memory_usage() < 4096) << std::endl;
+}
+
+template <class _Net>
+bool running_stats_agree(const _Net &net) {
+    NetworkStats full = net.stats(), fast = net.stats(false);
+    return full.neighbors.count == fast.neighbors.count && full.neighbors.size == fast.neighbors.size
+        && full.neighbors.buckets == fast.neighbors.buckets && full.neighbors.bytes == fast.neighbors.bytes
+        && full.total_bytes() == net.memory_usage();
+}
+
+template <class _Net>
+bool churn_and_check(_Net &net) {
+    bool ok = true;
+    for (int i = 0; i < 200; i++)
+        net.add_edge(i % 37, (i * 7) % 41);
+    net.add_edge(3, 3);
+    ok = ok && running_stats_agree(net);
+    for (int i = 0; i < 200; i += 3)
+        if (net.has_edge(i % 37, (i * 7) % 41)) net.remove_edge(i % 37, (i * 7) % 41);
+    net.remove_node(5);
+    net.remove_edge(3, 3);
+    ok = ok && running_stats_agree(net);
+    _Net copy;
+    copy = net;
+    ok = ok && running_stats_agree(copy) && running_stats_agree(_Net(net));
+    _Net moved(std::move(copy));
+    ok = ok && running_stats_agree(moved) && running_stats_agree(copy);
+    net.clear();
+    return ok && running_stats_agree(net);
+}
+
+void test_running_stats() {
+    Network<> hash;
+    Network<int, None, None, DenseStorage> dense;
+    Network<int, None, None, SortedStorage<>> sorted;
+    DirectedNetwork<> dhash;
+    DirectedNetwork<int, None, None, DenseStorage> ddense;
+    std::cout << "Running stats agree with a full walk: "
+              << churn_and_check(hash) << churn_and_check(dense) << churn_and_check(sorted)
+              << churn_and_check(dhash) << churn_and_check(ddense) << std::endl;
+}
+
 void test_performance_neighbors(Network<int> &net) {
     auto start = high_resolution_clock::now();
     for (auto i = 0; i < 100000; i++)
@@ -204,6 +315,257 @@ void test_performance_iterate_nodes_view(Network<int> &net) {
     std::cout << "Iterate nodes in DirectedNetwork: " << duration << " seconds.\n";
 }
 
+void test_edge_data_after_removal() {
+    Network<int, None, std::string> n;
+    n.add_edge(1, 2, "1-2");
+    n.add_edge(2, 3, "2-3");
+    n.add_edge(3, 4, "3-4");
+    n.add_edge(1, 2, "1-2 updated");
+    n.remove_edge(2, 3);
+    for (auto e : n.edges())
+        std::cout << "[" << e.first << "-" << e.second << "] data="
+                  << n(e.first, e.second) << std::endl;
+    std::cout << n << std::endl;
+}
+
+void test_edge_references() {
+    Network<int, None, double> net;
+    net.add_edge(0, 1, 0.5);
+    double *data = &net.edge(0, 1);
+    for (int i = 2; i < 5000; i++)
+        net.add_edge(i - 1, i, i);
+    std::cout << "Edge data reference kept across 4998 additions: "
+              << (data == &net.edge(0, 1) && *data == 0.5) << std::endl;
+}
+
+void test_freeze() {
+    Network<int, int, KindOfData> net;
+    net.add_edge(1, 2, {"1-2", 12});
+    net.add_edge(1, 3, {"1-3", 13});
+    net.add_edge(3, 4, {"3-4", 34});
+    net[1] = 100;
+    auto frozen = net.freeze();
+    frozen[1] += 1;
+    std::cout << frozen << std::endl;
+    std::cout << "Neighbors of 1 (frozen):";
+    for (const auto &n : frozen.iterate_neighbors(1))
+        std::cout << " " << n << "(amount=" << frozen.get_edge_data(1, n).amount << ")";
+    std::cout << std::endl << "Node 1 data: origin=" << net[1]
+              << " frozen=" << frozen[1] << std::endl;
+
+    DirectedNetwork<int> dn;
+    dn.add_edge(1, 2);
+    dn.add_edge(2, 1);
+    dn.add_edge(3, 1);
+    auto dfrozen = dn.freeze();
+    std::cout << dfrozen << std::endl;
+    std::cout << "Neighbors of 1 (frozen):";
+    for (const auto &n : dfrozen.neighbors(1))
+        std::cout << " " << n;
+    std::cout << std::endl;
+}
+
+void test_compress() {
+    Network<int, int, KindOfData> net;
+    net.add_edge(1, 2, {"1-2", 12});
+    net.add_edge(1, 300, {"1-300", 13});
+    net.add_edge(300, 4, {"300-4", 34});
+    net.add_edge(4, 4, {"4-4", 44});
+    net[1] = 100;
+    auto compressed = net.compress();
+    std::cout << compressed << std::endl;
+    std::cout << "Neighbors of 1 (compressed):";
+    for (const auto &n : compressed.iterate_neighbors(1))
+        std::cout << " " << n << "(amount=" << compressed.get_edge_data(1, n).amount << ")";
+    std::cout << std::endl << "Node 1 data: " << compressed[1]
+              << ", has edge 4-4: " << compressed.has_edge(4, 4)
+              << ", has edge 2-4: " << compressed.has_edge(2, 4) << std::endl;
+
+    std::vector<std::pair<int, int>> edges = {{1, 2}, {2, 1}, {3, 1}, {1, 1000}, {3, 1}};
+    CompressedDirectedNetwork<int> dn(edges.begin(), edges.end());
+    std::cout << dn << std::endl;
+    std::cout << "Neighbors of 1 (compressed):";
+    for (const auto &n : dn.neighbors(1))
+        std::cout << " " << n;
+    std::cout << std::endl;
+    CompressedNetwork<int> un(edges.begin(), edges.end());
+    std::cout << un << std::endl;
+}
+
+void test_common_neighbors() {
+    Network<int, None, None, SortedStorage<>> sorted;
+    Network<int> hashed;
+    for (int i = 0; i < 200; i++)
+        for (int k = 0; k < 6; k++) {
+            int j = randi(200);
+            sorted.add_edge(i, j);
+            hashed.add_edge(i, j);
+        }
+    for (int i = 1; i < 200; i++) {
+        sorted.add_edge(0, i);
+        hashed.add_edge(0, i);
+    }
+    for (int i : {0, 7}) {   /* far smaller than the hub 0 */
+        sorted.add_edge(200, i);
+        hashed.add_edge(200, i);
+    }
+    auto frozen = sorted.freeze();
+    bool same = true;
+    for (int i = 0; i <= 200; i++)
+        for (int j = 0; j <= 200; j++) {
+            int n = 0;
+            for (auto &k : hashed.neighbors(i))
+                n += hashed.has_edge(j, k);
+            same = same && sorted.count_common_neighbors(i, j) == n
+                        && hashed.count_common_neighbors(i, j) == n
+                        && frozen.count_common_neighbors(i, j) == n;
+        }
+    std::cout << "Common neighbors agree: " << same << std::endl;
+    std::cout << "Common neighbors of 1 and 2:";
+    for (auto &n : sorted.common_neighbors(1, 2))
+        std::cout << " " << n;
+    std::cout << std::endl << "Neighbors of 1 (sorted):";
+    for (auto &n : sorted.iterate_neighbors(1))
+        std::cout << " " << n;
+    std::cout << std::endl;
+}
+
+void test_handles() {
+    Network<int, int, KindOfData> net;
+    net.add_edge(1, 2, {"1-2", 12});
+    net.add_edge(1, 3, {"1-3", 13});
+    net.add_edge(3, 4, {"3-4", 34});
+    auto h = net.node_handle(1);
+    h.data() = 100;
+    std::cout << "Node 1 data=" << net[1] << " degree=" << h.degree() << ", neighbors:";
+    for (int i = 0; i < h.degree(); i++)
+        std::cout << " " << h.neighbor(i) << "(amount=" << h.edge_data(i).amount << ")";
+    h.edge_to(3).amount += 1;
+    std::cout << std::endl << "Edge 3-1 amount=" << net(3, 1).amount << std::endl;
+    auto eh = net.edge_handle(4, 3);
+    std::cout << "Edge handle " << eh.first() << "-" << eh.second()
+              << " desc=" << eh.data().desc << std::endl;
+    for (int i = 5; i < 200; i++)
+        net.add_edge(i - 1, i, {"added", i});
+    std::cout << "Edge handle after 195 additions: desc=" << eh.data().desc
+              << ", same record: " << (&eh.data() == &net(3, 4)) << std::endl;
+
+    DirectedNetwork<int, int, int, DenseStorage> dn;
+    dn.add_edge(1, 2, 12);
+    dn.add_edge(3, 1, 31);
+    auto dh = dn.node_handle(1);
+    std::cout << "Node 1 out=" << dh.out_degree() << " in=" << dh.in_degree()
+              << " successor=" << dh.successor(0) << "(" << dh.out_edge_data(0) << ")"
+              << " predecessor=" << dh.predecessor(0) << "(" << dh.in_edge_data(0) << ")" << std::endl;
+    try {
+        dn.edge(2, 1);
+    } catch (NoEdgeException<int> &e) {
+        std::cout << "Caught: " << e.what() << std::endl;
+    }
+    try {
+        dn.edge(1, 5);
+    } catch (NoNodeException<int> &e) {
+        std::cout << "Caught: " << e.what() << std::endl;
+    }
+}
+
+void test_views() {
+    Network<int, int, double> net;
+    for (int i = 0; i < 6; i++)
+        net.add_edge(i, (i + 1) % 6, i * 0.5);
+    net.add_edge(0, 3, 9.0);
+    auto sub = net.subgraph({0, 1, 2, 3, 42});
+    std::cout << "Subgraph " << sub << ", degree of 0: " << sub.degree(0)
+              << ", has 4: " << sub.has_node(4) << std::endl;
+    auto heavy = net.filtered_view(AllNodes(), [](int, int, double w) { return w >= 1.0; });
+    std::cout << "Heavy edges:";
+    for (auto e : heavy.iterate_edges())
+        std::cout << " [" << e.first << "-" << e.second << "]=" << heavy.get_edge_data(e.first, e.second);
+    std::cout << std::endl << "Heavy neighbors of 3:";
+    for (auto n : heavy.iterate_neighbors(3))
+        std::cout << " " << n;
+    std::cout << std::endl;
+
+    DirectedNetwork<int, None, None, DenseStorage> dn;
+    dn.add_edge(1, 2);
+    dn.add_edge(2, 3);
+    dn.add_edge(3, 1);
+    auto without3 = dn.filtered_view([](int i) { return i != 3; });
+    std::cout << "Without 3 " << without3 << ", successors of 1: " << without3.out_degree(1)
+              << ", predecessors of 1: " << without3.in_degree(1) << std::endl;
+    try {
+        without3.get_edge_data(2, 3);
+    } catch (NoNodeException<int> &e) {
+        std::cout << "Caught: " << e.what() << std::endl;
+    }
+
+    DirectedNetwork<int, None, int> mutual;
+    mutual.add_edge(1, 2, 12);
+    mutual.add_edge(2, 1, 21);
+    mutual.add_edge(2, 3, 23);
+    mutual.add_edge(3, 3, 33);
+    auto reverse = mutual.reverse_view();
+    std::cout << "Reverse " << reverse << ", successors of 3:";
+    for (auto n : reverse.iterate_successors(3))
+        std::cout << " " << n;
+    std::cout << ", edge 3-2: " << reverse.get_edge_data(3, 2) << ", has 2-3: " << reverse.has_edge(2, 3) << std::endl;
+    for (bool index : {false, true}) {
+        mutual.enable_reciprocal_index(index);
+        auto undirected = mutual.as_undirected_view();
+        std::cout << "Undirected " << undirected << ", edges:";
+        for (auto e : undirected.iterate_edges())
+            std::cout << " [" << e.first << "-" << e.second << "]=" << undirected.get_edge_data(e.first, e.second);
+        std::cout << ", degree of 2: " << undirected.degree(2) << ", edge 3-2: " << undirected.get_edge_data(3, 2) << std::endl;
+    }
+}
+
+void test_weighted_neighbors() {
+    Network<int, None, double> net;
+    net.add_edge(0, 1, 1.0);
+    net.add_edge(0, 2, 3.0);
+    net.add_edge(0, 3, 0.0);
+    XoshiroEngine rng(7);
+    int count[5] = {0};
+    for (int i = 0; i < 40000; i++)
+        count[net.weighted_random_neighbor(0, rng)]++;
+    std::cout << "Weighted neighbors of 0: 1 x" << (count[1] + 500) / 1000
+              << "k, 2 x" << (count[2] + 500) / 1000 << "k, 3 x" << count[3] << std::endl;
+    net.edge(0, 3) = 4.0;     /* drops the table of 0 */
+    net.remove_edge(0, 2);
+    count[1] = count[2] = count[3] = 0;
+    for (int i = 0; i < 50000; i++)
+        count[net.weighted_random_neighbor(0, rng)]++;
+    std::cout << "After changes: 1 x" << (count[1] + 500) / 1000
+              << "k, 2 x" << count[2] << ", 3 x" << (count[3] + 500) / 1000 << "k" << std::endl;
+
+    DirectedNetwork<int, None, int> dn;
+    dn.add_edge(1, 2, 1);
+    dn.add_edge(1, 3, 9);
+    dn.add_edge(4, 3, 1);
+    count[2] = count[3] = 0;
+    for (int i = 0; i < 10000; i++)
+        count[dn.weighted_random_successor(1, rng)]++;
+    std::cout << "Weighted successors of 1: 2 x" << (count[2] + 500) / 1000
+              << "k, 3 x" << (count[3] + 500) / 1000 << "k" << std::endl;
+    dn.add_edge(2, 3, 10);
+    count[1] = count[2] = count[4] = 0;
+    for (int i = 0; i < 20000; i++)
+        count[dn.weighted_random_predecessor(3, rng)]++;
+    std::cout << "Weighted predecessors of 3: 1 x" << (count[1] + 500) / 1000 << "k, 2 x"
+              << (count[2] + 500) / 1000 << "k, 4 x" << (count[4] + 500) / 1000 << "k" << std::endl;
+    try {
+        dn.weighted_random_successor(3, rng);
+    } catch (NoNeighborsException<int> &e) {
+        std::cout << "Caught: " << e.what() << std::endl;
+    }
+    dn.edge(1, 2) = -1;
+    try {
+        dn.weighted_random_successor(1, rng);
+    } catch (NetworkException &e) {
+        std::cout << "Caught: " << e.what() << std::endl;
+    }
+}
+
 void temp() {
 }
 
@@ -215,6 +577,20 @@ int main() {
 //    test_directed_network();
 //    test_copy_constructor();
 //    test_random_neighbor();
+    test_edge_data_after_removal();
+    test_edge_references();
+    test_freeze();
+    test_compress();
+    test_common_neighbors();
+    test_handles();
+    test_views();
+    test_weighted_neighbors();
+    test_random_edge();
+    test_clear();
+    test_iterate_edges();
+    test_directed_neighbors();
+    test_stats();
+    test_running_stats();
 
     auto start = high_resolution_clock::now();
     FullConnectedNetwork<> net(5000);
@@ -0,0 +1,76 @@
+#include <iostream>
+#include "cimnet/batch.h"
+
+typedef Network<Id, int, double> Net;
+
+void print_edges(const Net &net) {
+    for (auto e : net.iterate_edges())
+        std::cout << " [" << e.first << "-" << e.second << "]=" << net.get_edge_data(e.first, e.second);
+    std::cout << std::endl;
+}
+
+void test_batch() {
+    Net net;
+    for (int i = 0; i < 5; i++)
+        net.add_edge(i, (i + 1) % 5, i);
+    std::cout << net << std::endl;
+
+    Batch<Id, int, double> batch;
+    batch.remove_edge(1, 0);
+    batch.add_edge(0, 2, 10);
+    batch.add_edge(5, 0, 11);
+    batch.set_edge_data(3, 2, 12);
+    batch.set_node_data(5, 50);
+    DeltaLog<Id, int, double> log;
+    batch.commit(net, &log);
+    std::cout << net << ", " << log.size() << " changes:";
+    print_edges(net);
+    std::cout << "Node 5: " << net[5] << std::endl;
+
+    log.rollback(net);
+    std::cout << "Rolled back " << net << ":";
+    print_edges(net);
+
+    Net copy(net);
+    batch.commit(net, &log);
+    log.replay(copy);
+    std::cout << "Replayed " << copy << ":";
+    print_edges(copy);
+
+    Batch<Id, int, double> bad;
+    bad.add_edge(7, 8);
+    bad.remove_edge(0, 4);
+    bad.remove_edge(0, 4);
+    try {
+        bad.commit(net);
+    } catch (NetworkException &e) {
+        std::cout << e.what() << std::endl;
+    }
+    std::cout << "Unchanged " << net << ":";
+    print_edges(net);
+}
+
+void test_directed_batch() {
+    DirectedNetwork<> net;
+    net.enable_reciprocal_index();
+    net.add_edge(0, 1);
+    net.add_edge(1, 2);
+    Batch<> batch;
+    batch.add_edge(1, 0);
+    batch.add_edge(2, 1);
+    batch.remove_edge(0, 1);
+    DeltaLog<> log;
+    batch.commit(net, &log);
+    std::cout << net << ", mutual neighbors of 1:";
+    for (auto &n : net.mutual_neighbors(1))
+        std::cout << " " << n;
+    std::cout << std::endl;
+    log.rollback(net);
+    std::cout << "Rolled back " << net << std::endl;
+}
+
+int main() {
+    test_batch();
+    test_directed_batch();
+    return 0;
+}
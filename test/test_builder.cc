@@ -0,0 +1,56 @@
+#include <iostream>
+#include "cimnet/builder.h"
+
+void test_parallel_builder() {
+    ParallelBuilder<Id, None, double> builder(4);
+    builder.run([](int w, EdgeBuffer<Id, None, double> &buf) {
+        for (int i = w; i < 20; i += 4)
+            buf.add_edge(i, (i + 1) % 20, i);
+        buf.add_edge(0, 1, 100 + w);
+    });
+    builder.buffer(0).add_node(30);
+
+    Network<Id, None, double> net;
+    builder.build(net, 3);
+    std::cout << net << std::endl;
+    std::cout << "Neighbors of 0:";
+    for (auto &n : net.iterate_neighbors(0))
+        std::cout << " " << n << "(" << net(0, n) << ")";
+    std::cout << std::endl;
+
+    Network<Id, None, double> serial;
+    for (int w = 0; w < 4; w++) {
+        for (int i = w; i < 20; i += 4)
+            serial.add_edge(i, (i + 1) % 20, i);
+        serial.add_edge(0, 1, 100 + w);
+    }
+    serial.add_node(30);
+    bool same = net.number_of_edges() == serial.number_of_edges()
+                && net.memory_usage() == net.stats().total_bytes();
+    for (auto e : serial.iterate_edges())
+        same = same && net.has_edge(e.first, e.second) && net(e.first, e.second) == serial(e.first, e.second);
+    std::cout << "Same as serial: " << same << std::endl;
+}
+
+void test_parallel_builder_directed() {
+    ParallelBuilder<> builder(2);
+    builder.run([](int w, EdgeBuffer<> &buf) {
+        for (int i = 0; i < 5; i++)
+            buf.add_edge(i, (i + 1 + w) % 5);
+    });
+    DirectedNetwork<> net;
+    net.enable_reciprocal_index();
+    builder.build(net, 2);
+    std::cout << net << ", running stats agree: "
+              << (net.memory_usage() == net.stats().total_bytes()) << std::endl;
+    std::cout << "Mutual neighbors of 0:";
+    for (auto &n : net.mutual_neighbors(0))
+        std::cout << " " << n;
+    std::cout << std::endl;
+}
+
+int main() {
+    test_parallel_builder();
+    test_parallel_builder_directed();
+    return 0;
+}
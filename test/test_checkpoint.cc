@@ -0,0 +1,209 @@
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "cimnet/network.h"
+#include "cimnet/checkpoint.h"
+
+using namespace std::chrono;
+
+typedef Network<int, int, std::string> StateNet;
+
+/* One round of a toy contagion with rewiring, drawing from the network
+ * and from both engines. Returns a digest of what it saw. */
+long step(StateNet &net, MTEngine &mt, Xoshiro4Engine &x4) {
+    long digest = 0;
+    for (int i : net.nodes()) {
+        if (net.degree(i) == 0) continue;
+        int j = net.random_neighbor(i, mt);
+        if (net[j] > 0 && x4.randf() < 0.3) net[i] = net[j] + 1;
+        digest = digest * 31 + j;
+    }
+    auto e = net.random_edge(x4);
+    net.remove_edge(e.first, e.second);
+    int a = mt.randi(net.number_of_nodes()), b = x4.randi(net.number_of_nodes());
+    net.add_edge(a, b, std::to_string(a) + "-" + std::to_string(b));
+    return digest;
+}
+
+void test_resume() {
+    StateNet net;
+    MTEngine gen(5);
+    for (int i = 0; i < 300; i++)
+        net.add_edge(i, gen.randi(300), "initial");
+    for (int i = 0; i < 300; i += 7)
+        net.add_node(i, 1);
+
+    StateNet straight(net);
+    MTEngine mt1(1);
+    Xoshiro4Engine x1(2);
+    std::vector<long> expected;
+    for (int r = 0; r < 40; r++) {
+        if (r == 20) x1.randf();
+        expected.push_back(step(straight, mt1, x1));
+    }
+
+    /* Killed after 20 rounds, then resumed in fresh objects */
+    MTEngine mt2(1);
+    Xoshiro4Engine x2(2);
+    std::vector<long> digests;
+    for (int r = 0; r < 20; r++)
+        digests.push_back(step(net, mt2, x2));
+    x2.randf();     /* leave numbers in the buffer */
+    std::stringstream saved;
+    save_checkpoint(saved, net, mt2, x2);
+
+    StateNet resumed;
+    MTEngine mt3;
+    Xoshiro4Engine x3;
+    load_checkpoint(saved, resumed, mt3, x3);
+    for (int r = 0; r < 20; r++)
+        digests.push_back(step(resumed, mt3, x3));
+    bool same = digests == expected && resumed.nodes() == straight.nodes()
+                && resumed.number_of_edges() == straight.number_of_edges();
+    for (int i : straight.nodes())
+        same = same && resumed[i] == straight[i] && resumed.neighbors(i) == straight.neighbors(i);
+    for (auto e : straight.iterate_edges())
+        same = same && resumed.get_edge_data(e.first, e.second) == straight.get_edge_data(e.first, e.second);
+    std::cout << "Resumed run matches straight run: " << same << std::endl;
+}
+
+void test_directed() {
+    DirectedNetwork<int, double, int, DenseStorage> dn;
+    for (int i = 0; i < 50; i++) {
+        dn.add_edge(i, (i * 7) % 50, i);
+        dn.add_edge((i * 7) % 50, i, -i);
+    }
+    dn.remove_edge(3, 21);
+    dn.enable_reciprocal_index();
+    dn.node(4) = 0.5;
+    std::vector<XoshiroEngine> streams = random_streams(3, 9);
+    PhiloxEngine philox(9, 1, 2, 3);
+    philox.next();
+
+    std::stringstream saved;
+    save_checkpoint(saved, dn, streams, philox);
+    DirectedNetwork<int, double, int, DenseStorage> loaded;
+    std::vector<XoshiroEngine> streams2(3);
+    PhiloxEngine philox2(0);
+    load_checkpoint(saved, loaded, streams2, philox2);
+    bool same = loaded.number_of_edges() == dn.number_of_edges() && loaded.node(4) == 0.5
+                && loaded.has_reciprocal_index() && loaded.mutual_neighbors(7) == dn.mutual_neighbors(7)
+                && loaded.memory_usage() == loaded.stats().total_bytes()
+                && philox2.next() == philox.next();
+    for (int s = 0; s < 3; s++)
+        for (int i = 0; i < 50; i++)
+            same = same && loaded.random_successor(i, streams2[s]) == dn.random_successor(i, streams[s])
+                        && loaded.random_predecessor(i, streams2[s]) == dn.random_predecessor(i, streams[s]);
+    std::cout << "Directed network and engines restored: " << same << std::endl;
+}
+
+void test_errors() {
+    Network<int> net;
+    net.add_edge(1, 2);
+    MTEngine mt;
+    std::stringstream saved;
+    save_checkpoint(saved, net, mt);
+    std::string bytes = saved.str();
+
+    DirectedNetwork<int> dn;
+    try {
+        std::stringstream in(bytes);
+        load_checkpoint(in, dn, mt);
+    } catch (NetworkException &e) {
+        std::cout << "Caught: " << e.what() << std::endl;
+    }
+    try {
+        std::stringstream in(bytes.substr(0, bytes.size() / 2));
+        load_checkpoint(in, net, mt);
+    } catch (NetworkException &e) {
+        std::cout << "Caught: " << e.what() << std::endl;
+    }
+    try {
+        std::stringstream in(bytes);
+        XoshiroEngine x;
+        load_checkpoint(in, net, x);
+    } catch (NetworkException &e) {
+        std::cout << "Caught: " << e.what() << std::endl;
+    }
+    try {
+        std::stringstream in(bytes);
+        Network<int, double> other;
+        load_checkpoint(in, other, mt);
+    } catch (NetworkException &e) {
+        std::cout << "Caught: " << e.what() << std::endl;
+    }
+}
+
+/* A stream that cannot seek, like a pipe */
+struct PipeBuf : std::stringbuf {
+    explicit PipeBuf (const std::string &s) : std::stringbuf(s) {}
+    pos_type seekoff(off_type, std::ios::seekdir, std::ios::openmode) override {
+        return pos_type(-1);
+    }
+};
+
+/* Counts past what the file holds are refused instead of allocated. */
+void test_corrupt_counts() {
+    Network<int, std::string> net;
+    net.add_node(1, "one");
+    MTEngine mt;
+    std::stringstream saved;
+    save_checkpoint(saved, net, mt);
+    std::string bytes = saved.str();
+    uint64_t huge = 1ULL << 60;
+    std::string many_nodes(bytes), long_name(bytes);
+    std::memcpy(&many_nodes[29], &huge, 8);     /* after the header and degree hint */
+    std::memcpy(&long_name[49], &huge, 8);      /* after the counts and id of node 1 */
+
+    try {
+        std::stringstream in(many_nodes);
+        load_checkpoint(in, net, mt);
+    } catch (NetworkException &e) {
+        std::cout << "Caught: " << e.what() << std::endl;
+    }
+    try {
+        std::stringstream in(long_name);
+        load_checkpoint(in, net, mt);
+    } catch (NetworkException &e) {
+        std::cout << "Caught: " << e.what() << std::endl;
+    }
+    try {
+        PipeBuf buf(long_name);
+        std::istream in(&buf);
+        load_checkpoint(in, net, mt);
+    } catch (NetworkException &e) {
+        std::cout << "Caught from a pipe: " << e.what() << std::endl;
+    }
+    PipeBuf buf(bytes);
+    std::istream in(&buf);
+    load_checkpoint(in, net, mt);
+    std::cout << "Loaded from a pipe: " << (net.number_of_nodes() == 1 && net[1] == "one") << std::endl;
+}
+
+void test_performance() {
+    ERNetwork<> net(100000, 0.0002);
+    XoshiroEngine x(1);
+    auto start = high_resolution_clock::now();
+    save_checkpoint("test_checkpoint.bin", net, default_engine(), x);
+    auto mid = high_resolution_clock::now();
+    ERNetwork<> loaded(0, 0);
+    load_checkpoint("test_checkpoint.bin", loaded, default_engine(), x);
+    auto end = high_resolution_clock::now();
+    std::cout << "Checkpoint of " << net << ": saved in "
+              << duration_cast<milliseconds>(mid - start).count() << " ms, loaded in "
+              << duration_cast<milliseconds>(end - mid).count() << " ms, same edges: "
+              << (loaded.number_of_edges() == net.number_of_edges()) << std::endl;
+    std::remove("test_checkpoint.bin");
+}
+
+int main() {
+    test_resume();
+    test_directed();
+    test_errors();
+    test_corrupt_counts();
+    test_performance();
+    return 0;
+}
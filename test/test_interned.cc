@@ -0,0 +1,62 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "cimnet/interned.h"
+
+void test_interned_network() {
+    InternedNetwork<std::string, int, double> net;
+    net.add_edge("alice", "bob", 0.5);
+    net.add_edge("bob", "carol", 1.5);
+    net.add_edge("carol", "alice", 2.5);
+    net["alice"] = 30;
+    std::cout << net << std::endl;
+    std::cout << "Neighbors of bob:";
+    for (auto &n : net.iterate_neighbors("bob"))
+        std::cout << " " << n << "(" << net("bob", n) << ")";
+    std::cout << std::endl;
+    net.remove_node("carol");
+    net.add_edge("dave", "alice");
+    for (auto e : net.iterate_edges())
+        std::cout << "[" << e.first << "-" << e.second << "] internal ["
+                  << net.internal_id(e.first) << "-" << net.internal_id(e.second) << "]"
+                  << std::endl;
+    try {
+        net.edge("bob", "dave");
+    } catch (NetworkException &e) {
+        std::cout << e.what() << std::endl;
+    }
+}
+
+void test_interned_directed_network() {
+    InternedDirectedNetwork<std::string> net;
+    net.add_edge("10.0.0.1", "10.0.0.2");
+    net.add_edge("10.0.0.2", "10.0.0.1");
+    net.add_edge("10.0.0.3", "10.0.0.1");
+    std::cout << net << std::endl;
+    std::cout << "Neighbors of 10.0.0.1:";
+    for (auto &n : net.iterate_neighbors("10.0.0.1"))
+        std::cout << " " << n;
+    std::cout << std::endl << "Mutual neighbors of 10.0.0.1:";
+    for (auto &n : net.mutual_neighbors("10.0.0.1"))
+        std::cout << " " << n;
+    std::cout << std::endl;
+}
+
+void test_bulk_nodes() {
+    std::vector<std::string> ids;
+    for (int i = 0; i < 10000; i++)
+        ids.push_back("node-" + std::to_string(i));
+    InternedNetwork<std::string> net;
+    net.add_nodes_from(ids.begin(), ids.end());
+    InternedDirectedNetwork<std::string> dnet;
+    dnet.add_nodes_from(ids.begin(), ids.end());
+    std::cout << "Bulk nodes without rehashing: "
+              << (net.stats().rehashes == 0 && dnet.stats().rehashes == 0) << std::endl;
+}
+
+int main() {
+    test_interned_network();
+    test_interned_directed_network();
+    test_bulk_nodes();
+    return 0;
+}
@@ -1,8 +1,10 @@
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include "cimnet/network.h"
 #include "cimnet/_base_net.h"
 #include "cimnet/io.h"
+#include "cimnet/interned.h"
 
 void test_save_edge_list(const Network<int> &net) {
     std::cout << "Testing writing edge list of network ...\n";
@@ -46,6 +48,47 @@ void test_save_adj_matrix(const DirectedNetwork<int> &net) {
     out.close();
 }
 
+void test_load_edge_list() {
+    std::cout << "Testing loading edge list as network ...\n";
+    std::ifstream in("test_edges.csv", std::ios::in);
+    auto net = load_network_from_edge_list<int>(in);
+    in.close();
+    std::cout << net << std::endl;
+}
+
+void test_load_directed_edge_list() {
+    std::cout << "Testing loading edge list as directed network ...\n";
+    std::ifstream in("test_edges.csv", std::ios::in);
+    auto net = load_directed_network_from_edge_list<int>(in);
+    in.close();
+    std::cout << net << std::endl;
+}
+
+void test_save_views(const DirectedNetwork<int> &net) {
+    std::cout << "Testing writing views of directed network ...\n";
+    std::ostringstream reverse, undirected;
+    save_edge_list(reverse, net.reverse_view(), " ");
+    save_adjacency_list(undirected, net.as_undirected_view(), " ");
+    std::cout << "Reverse edges:\n" << reverse.str() << "Undirected adjacency list:\n" << undirected.str();
+}
+
+struct DerivedDirected : DirectedNetwork<int> {};
+
+void test_save_other_directed() {
+    std::cout << "Testing writing other directed networks ...\n";
+    DerivedDirected derived;
+    derived.add_edge(1, 2);
+    InternedDirectedNetwork<std::string> interned;
+    interned.add_edge("a", "b");
+    std::ostringstream list, matrix, frozen, names;
+    save_adjacency_list(list, derived, " ");
+    save_adjacency_matrix(matrix, derived, std::vector<int>{1, 2}, " ", false);
+    save_adjacency_list(frozen, derived.freeze(), " ");
+    save_adjacency_list(names, interned, " ");
+    std::cout << "Derived adjacency list:\n" << list.str() << "Derived adjacency matrix:\n" << matrix.str()
+              << "Frozen adjacency list:\n" << frozen.str() << "Interned adjacency list:\n" << names.str();
+}
+
 int main() {
     DirectedNetwork<int> n;
     n.add_edge(1, 2);
@@ -57,6 +100,10 @@ int main() {
     test_save_edge_list(n);
     test_save_adj_list(n);
     test_save_adj_matrix(n);
+    test_load_edge_list();
+    test_load_directed_edge_list();
+    test_save_views(n);
+    test_save_other_directed();
 
     return 0;
 }
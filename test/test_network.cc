@@ -55,6 +55,14 @@ void test_scale_free() {
     std::cout << n << std::endl;
 }
 
+void test_dense_storage() {
+    std::cout << "Test GridNetwork with DenseStorage: w=10, h=20" << std::endl;
+    GridNetwork<None, None, DenseStorage> n(10, 20);
+    std::cout << n << std::endl;
+    n.remove_node(0);
+    std::cout << "Remove node 0: " << n << std::endl;
+}
+
 /* Function for creating custom mask function */
 CustomizableGridNetwork<>::RangeMask cross_mask(double radius) {
     CustomizableGridNetwork<>::RangeMask mask;
@@ -111,5 +119,6 @@ int main(void) {
     test_kagome();
     test_scale_free();
     test_customizable_grid();
+    test_dense_storage();
     return 0;
 }
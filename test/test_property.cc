@@ -0,0 +1,57 @@
+#include <iostream>
+#include "cimnet/network.h"
+#include "cimnet/property.h"
+
+typedef enum {
+    Susceptible,
+    Infected,
+    Recovered
+} Compartment;
+
+void test_node_properties() {
+    GridNetwork<> net(10, 10);
+    NodeProperties<int> props(net);
+    auto &status = props.add_property<unsigned char>("status", Susceptible);
+    auto &weight = props.add_property<double>("weight", 1.0);
+    for (int i = 0; i < props.size(); i += 3)
+        status[i] = Infected;
+    status[props.index_of(0)] = Recovered;
+
+    auto hist = status.histogram(3);
+    std::cout << "S: " << hist[Susceptible] << " I: " << hist[Infected]
+              << " R: " << hist[Recovered] << std::endl;
+    std::cout << "Infected: " << status.count(Infected) << std::endl;
+    std::cout << "Total weight: " << weight.sum() << std::endl;
+
+    net.add_edge(100, 0);
+    props.sync(net);
+    std::cout << "After sync: " << props.size() << " nodes, node 100 has status "
+              << (int)props.property<unsigned char>("status")[props.index_of(100)]
+              << std::endl;
+
+    std::vector<int> before(101);
+    for (int i = 0; i <= 100; i++)
+        before[i] = status[props.index_of(i)];
+    int infected = status.count(Infected) - (before[55] == Infected);
+    net.remove_node(0);
+    net.remove_node(55);
+    props.sync(net);
+    bool kept = !props.index().has(0) && !props.index().has(55);
+    for (int i : net.nodes())
+        kept = kept && status[props.index_of(i)] == before[i];
+    std::cout << "After removing nodes 0 and 55: " << props.size() << " nodes, infected: "
+              << status.count(Infected) << " (expected " << infected << "), recovered: "
+              << status.count(Recovered) << ", weight: " << weight.sum()
+              << ", statuses kept: " << kept << std::endl;
+
+    try {
+        props.property<int>("status");
+    } catch (NetworkException &e) {
+        std::cout << e.what() << std::endl;
+    }
+}
+
+int main() {
+    test_node_properties();
+    return 0;
+}
@@ -0,0 +1,167 @@
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "cimnet/network.h"
+#include "cimnet/random.h"
+
+void test_engines() {
+    MTEngine a(42), b(42);
+    bool same = true;
+    for (int i = 0; i < 1000; i++)
+        same = same && a.randi(1000) == b.randi(1000);
+    sgenrand(42);
+    MTEngine c(42);
+    for (int i = 0; i < 1000; i++)
+        same = same && randi(1000) == c.randi(1000);
+    std::cout << "Same seed, same numbers: " << same << std::endl;
+
+    XoshiroEngine x(7), y(7);
+    y.jump();
+    double sum = 0;
+    for (int i = 0; i < 100000; i++)
+        sum += x.randf();
+    std::cout << "Jumped engine differs: " << (x.randi(1 << 30) != y.randi(1 << 30))
+              << ", mean of randf: " << (sum / 100000 > 0.49 && sum / 100000 < 0.51) << std::endl;
+}
+
+void test_streams() {
+    std::vector<XoshiroEngine> streams = random_streams(4, 2022);
+    std::vector<XoshiroEngine> again = random_streams(4, 2022);
+    std::vector<long> counts(4), serial(4);
+    std::vector<std::thread> workers;
+    for (int w = 0; w < 4; w++)
+        workers.emplace_back([&, w]() {
+            ERNetwork<> net(200, 0.05, streams[w]);
+            counts[w] = net.number_of_edges();
+        });
+    for (auto &t : workers)
+        t.join();
+    for (int w = 0; w < 4; w++)
+        serial[w] = ERNetwork<>(200, 0.05, again[w]).number_of_edges();
+    std::cout << "Threaded ER networks match serial ones: " << (counts == serial) << std::endl;
+
+    XoshiroEngine e1(3), e2(3);
+    ScaleFreeNetwork<> sf1(100, 2, e1), sf2(100, 2, e2);
+    bool same = sf1.number_of_edges() == sf2.number_of_edges();
+    for (auto e : sf1.iterate_edges())
+        same = same && sf2.has_edge(e.first, e.second);
+    for (int i = 0; i < 100; i++)
+        same = same && sf1.random_neighbor(i, e1) == sf2.random_neighbor(i, e2)
+                    && sf1.random_edge(e1) == sf2.random_edge(e2);
+    std::cout << "Same engine, same scale-free network and walks: " << same << std::endl;
+}
+
+void test_bulk() {
+    MTEngine a(11), b(11);
+    std::vector<double> f(2000);
+    std::vector<long> k(1500);
+    a.fill_randf(f.data(), f.size());
+    a.fill_randi(k.data(), k.size(), 37);
+    bool same = true;
+    for (double x : f)
+        same = same && x == b.randf();
+    for (long x : k)
+        same = same && x == b.randi(37);
+    std::cout << "MT bulk matches single draws: " << same << std::endl;
+
+    Xoshiro4Engine c(11), d(11);
+    XoshiroEngine lane0(11), lane1(11);
+    lane1.jump();
+    same = c.next() == lane0.next() && c.next() == lane1.next();
+    d.next();
+    d.next();
+    c.fill_randf(f.data(), 999);
+    c.fill_randi(k.data(), 1001, 6);
+    for (int i = 0; i < 999; i++)
+        same = same && f[i] == d.randf() && f[i] >= 0 && f[i] < 1;
+    std::vector<int> counts(6);
+    for (int i = 0; i < 1001; i++) {
+        same = same && k[i] == d.randi(6);
+        counts[k[i]]++;
+    }
+    bool uniform = true;
+    for (int x : counts)
+        uniform = uniform && x > 120 && x < 215;
+    std::cout << "Xoshiro4 lanes and bulk match single draws: " << same
+              << ", bounded integers uniform: " << uniform << std::endl;
+}
+
+/* One synchronous step: node i becomes 1 with probability 0.3 if a
+ * random neighbor is 1, drawing from the engine of (i, step). */
+std::vector<int> sync_step(const Network<int> &net, const std::vector<int> &state,
+                           int step, int n_threads) {
+    std::vector<int> next(state);
+    std::vector<std::thread> workers;
+    for (int w = 0; w < n_threads; w++)
+        workers.emplace_back([&, w]() {
+            for (int i = w; i < net.number_of_nodes(); i += n_threads) {
+                PhiloxEngine rng(2022, 0, i, step);
+                if (state[net.random_neighbor(i, rng)] && rng.randf() < 0.3)
+                    next[i] = 1;
+            }
+        });
+    for (auto &t : workers)
+        t.join();
+    return next;
+}
+
+void test_counter() {
+    uint32_t ctr[4] = {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, out[4];
+    philox4x32(ctr, 0x299f31d0a4093822ULL, out);
+    std::cout << std::hex << "Philox4x32-10: " << out[0] << " " << out[1] << " "
+              << out[2] << " " << out[3] << std::dec << std::endl;
+
+    RegularNetwork<> net(300, 3);
+    std::vector<int> one(300), four(300);
+    one[0] = four[0] = 1;
+    for (int t = 0; t < 30; t++) {
+        one = sync_step(net, one, t, 1);
+        four = sync_step(net, four, t, 4);
+    }
+    int infected = 0;
+    for (int x : one)
+        infected += x;
+    std::cout << "Same states with 1 and 4 threads: " << (one == four)
+              << ", reached: " << (infected > 1) << std::endl;
+}
+
+/* Threads drawing weighted neighbors at once build each alias table
+ * once and draw the same as one thread does. */
+void test_weighted_threads() {
+    Network<int, None, double> net;
+    XoshiroEngine gen(5);
+    for (int i = 0; i < 2000; i++)
+        net.add_edge(i, gen.randi(2000), 1 + gen.randi(9));
+    std::vector<std::vector<int>> drawn(4, std::vector<int>(2000));
+    std::vector<std::thread> workers;
+    for (int w = 0; w < 4; w++)
+        workers.emplace_back([&, w]() {
+            for (int r = 0; r < 5; r++)
+                for (int i = 0; i < 2000; i++) {
+                    PhiloxEngine rng(2022, 0, i, r);
+                    drawn[w][i] += net.weighted_random_neighbor(i, rng);
+                }
+        });
+    for (auto &t : workers)
+        t.join();
+    Network<int, None, double> copy(net);
+    std::vector<int> serial(2000);
+    for (int r = 0; r < 5; r++)
+        for (int i = 0; i < 2000; i++) {
+            PhiloxEngine rng(2022, 0, i, r);
+            serial[i] += copy.weighted_random_neighbor(i, rng);
+        }
+    bool same = true;
+    for (auto &d : drawn)
+        same = same && d == serial;
+    std::cout << "Threaded weighted neighbors match serial ones: " << same << std::endl;
+}
+
+int main() {
+    test_engines();
+    test_streams();
+    test_bulk();
+    test_counter();
+    test_weighted_threads();
+    return 0;
+}
@@ -0,0 +1,75 @@
+#include <iostream>
+#include <type_traits>
+#include <utility>
+#include "cimnet/network.h"
+#include "cimnet/shared.h"
+
+/* Vectors of networks move them when they grow instead of copying. */
+static_assert(std::is_nothrow_move_constructible<Network<>>::value
+              && std::is_nothrow_move_assignable<Network<>>::value, "Network moves may throw.");
+static_assert(std::is_nothrow_move_constructible<DirectedNetwork<int, int, int, DenseStorage>>::value
+              && std::is_nothrow_move_assignable<DirectedNetwork<int, int, int, DenseStorage>>::value,
+              "DirectedNetwork moves may throw.");
+static_assert(std::is_nothrow_move_constructible<ERNetwork<>>::value, "Generated network moves may throw.");
+
+void test_move() {
+    Network<int, int, int> net;
+    for (int i = 0; i < 5; i++)
+        net.add_edge(i, (i + 1) % 5, i);
+    Network<int, int, int> moved(std::move(net));
+    std::cout << "Moved " << moved << ", source " << net << std::endl;
+    net = std::move(moved);
+    net.add_edge(0, 2, 9);
+    std::cout << "Moved back " << net << ", edge 2-0: " << net(2, 0) << std::endl;
+
+    DirectedNetwork<int> dn;
+    dn.enable_reciprocal_index();
+    dn.add_edge(1, 2);
+    dn.add_edge(2, 1);
+    DirectedNetwork<int> dmoved;
+    dmoved = std::move(dn);
+    std::cout << "Moved " << dmoved << ", mutual 1-2: " << dmoved.is_mutual(1, 2)
+              << ", source " << dn << std::endl;
+}
+
+void test_shared() {
+    Network<int, int, int> net;
+    for (int i = 0; i < 5; i++)
+        net.add_edge(i, (i + 1) % 5, i);
+    net[0] = 7;
+    SharedNetwork<int, int, int> origin(std::move(net));
+    std::vector<SharedNetwork<int, int, int>> replicas(3, origin);
+    for (int r = 0; r < 3; r++)
+        replicas[r][1] = r;
+    std::cout << "Shared: " << replicas[0].is_shared() << ", node 0: " << replicas[2][0]
+              << ", node 1:";
+    for (auto &r : replicas)
+        std::cout << " " << r[1];
+    std::cout << std::endl;
+
+    replicas[1].add_edge(1, 5, 15);
+    replicas[2](0, 1) = 100;
+    std::cout << "Replica 0 " << replicas[0] << " edge 0-1=" << replicas[0].get_edge_data(0, 1)
+              << ", replica 1 " << replicas[1] << " node 5=" << replicas[1][5]
+              << ", replica 2 edge 0-1=" << replicas[2].get_edge_data(0, 1) << std::endl;
+    std::cout << "Shared: " << origin.is_shared() << " " << replicas[1].is_shared()
+              << " " << replicas[2].is_shared() << std::endl;
+    try {
+        replicas[0].remove_edge(0, 2);
+    } catch (NoEdgeException<int> &e) {
+        std::cout << "Caught: " << e.what() << ", still shared: " << replicas[0].is_shared() << std::endl;
+    }
+
+    DirectedNetwork<int, int> dn;
+    dn.add_edge(1, 2);
+    SharedDirectedNetwork<int, int> d1(dn), d2(d1);
+    d2.remove_edge(1, 2);
+    std::cout << "Directed " << d1 << " successors of 1: " << d1.out_degree(1)
+              << ", copy " << d2 << " successors of 1: " << d2.out_degree(1) << std::endl;
+}
+
+int main() {
+    test_move();
+    test_shared();
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "cimnet/network.h"
+#include "cimnet/shared.h"
+#include "cimnet/snapshot.h"
+
+void test_versions() {
+    Network<int, int> net;
+    net.add_edge(0, 1);
+    VersionedNetwork<Network<int, int>> vnet(net);
+    Snapshot<Network<int, int>> old = vnet.pin();
+    vnet.writer().add_edge(1, 2);
+    vnet.writer()[2] = 7;
+    std::cout << "Before publish: version " << vnet.version() << ", " << *vnet.pin() << std::endl;
+    vnet.publish();
+    Snapshot<Network<int, int>> now = vnet.pin();
+    std::cout << "Pinned version " << old.version() << ": " << *old << std::endl;
+    std::cout << "Current version " << now.version() << ": " << *now
+              << ", data of 2: " << now->get_node_data(2) << std::endl;
+    old.reset();
+    vnet.writer().remove_node(0);
+    vnet.publish();
+    vnet.publish();
+    std::cout << "Version " << vnet.version() << ": " << *vnet.pin()
+              << ", still pinned version " << now.version() << ": " << *now << std::endl;
+}
+
+void test_concurrent() {
+    VersionedNetwork<Network<int>> vnet;
+    std::atomic<bool> done(false);
+    std::atomic<int> bad(0);
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; r++)
+        readers.emplace_back([&]() {
+            while (!done) {
+                Snapshot<Network<int>> s = vnet.pin();
+                /* Version v holds the v - 1 edges of the path 0-1-...-(v-1). */
+                int degrees = 0;
+                for (auto n : s->nodes())
+                    degrees += s->degree(n);
+                int expected = s.version() - 1;
+                if (s->number_of_edges() != expected || degrees != 2 * expected)
+                    bad++;
+            }
+        });
+    for (int i = 0; i < 1000; i++) {
+        vnet.writer().add_edge(i, i + 1);
+        vnet.publish();
+    }
+    done = true;
+    for (auto &t : readers)
+        t.join();
+    std::cout << "Final " << *vnet.pin() << ", version " << vnet.version()
+              << ", inconsistent reads: " << bad << std::endl;
+}
+
+/* Versions of a shared network share its topology until it changes. */
+void test_shared_versions() {
+    Network<int, int> net;
+    for (int i = 0; i < 100; i++)
+        net.add_edge(i, (i + 1) % 100);
+    VersionedNetwork<SharedNetwork<int, int>> vnet{SharedNetwork<int, int>(std::move(net))};
+    Snapshot<SharedNetwork<int, int>> first = vnet.pin();
+    vnet.writer()[5] = 1;
+    vnet.publish();
+    Snapshot<SharedNetwork<int, int>> second = vnet.pin();
+    bool shared = &first->topology() == &second->topology()
+                  && &second->topology() == &vnet.writer().topology();
+    vnet.writer().add_edge(0, 50);
+    vnet.publish();
+    Snapshot<SharedNetwork<int, int>> third = vnet.pin();
+    std::cout << "Node data publish shares the topology: " << shared
+              << ", data of 5: " << first->get_node_data(5) << " then " << second->get_node_data(5)
+              << ", edges: " << second->number_of_edges() << " then " << third->number_of_edges()
+              << ", copied once: " << (&second->topology() != &third->topology()) << std::endl;
+}
+
+int main() {
+    test_versions();
+    test_concurrent();
+    test_shared_versions();
+    return 0;
+}